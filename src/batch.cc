@@ -0,0 +1,331 @@
+//===================================================================================================================
+//  batch.cc -- Write a whole batch of files at once, through io_uring where the kernel has it
+//
+//  When one run builds many sets of images, writing them one file at a time means a system call (and a wait) for
+//  each.  Here every temporary file is opened first, then every write is queued on an io_uring and submitted with
+//  a single io_uring_enter() which also waits for them all to finish.  The files are then closed and renamed into
+//  place as WriteFileAtomic() does, so nobody ever sees a partial image.
+//
+//  There is no liburing here; the ring is set up with the raw system calls.  If the kernel does not have io_uring
+//  (or it is not allowed, as in some containers), if it will not take every write, or if a write comes back short,
+//  the rest is done with pwrite().
+//
+//  -----------------------------------------------------------------------------------------------------------------
+//
+//     Date      Tracker  Version  Pgmr  Description
+//  -----------  -------  -------  ----  ---------------------------------------------------------------------------
+//  2026-Oct-16  Initial  v0.0.1   ADCL  Initial version
+//
+//===================================================================================================================
+
+
+#include <cstdint>
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#define HAVE_IO_URING 1
+#endif
+
+#include "eeprom.h"
+
+
+
+//
+// -- The most writes queued on the ring at a time; a bigger batch is submitted in turns
+//    ----------------------------------------------------------------------------------
+const unsigned RING_ENTRIES = 256;
+
+
+
+//
+// -- One file in the batch as it is written
+//    --------------------------------------
+typedef struct Pending {
+    int fd;
+    size_t done;                             // the bytes written so far
+    char tmp[FILENAME_MAX];
+} Pending;
+
+
+
+#ifdef HAVE_IO_URING
+
+//
+// -- The ring, mapped from the kernel
+//    --------------------------------
+typedef struct Ring {
+    int fd;
+    unsigned entries;
+    void *sq;
+    size_t sqLen;
+    void *cq;
+    size_t cqLen;
+    struct io_uring_sqe *sqes;
+    size_t sqesLen;
+    unsigned *sqHead, *sqTail, *sqMask, *sqArray;
+    unsigned *cqHead, *cqTail, *cqMask;
+    struct io_uring_cqe *cqes;
+} Ring;
+
+
+
+//
+// -- Set up the ring; false (with nothing left behind) if the kernel will not give us one
+//    ------------------------------------------------------------------------------------
+static bool OpenRing(Ring *ring, unsigned entries)
+{
+    struct io_uring_params p;
+
+    memset(&p, 0, sizeof(p));
+    memset(ring, 0, sizeof(Ring));
+
+    ring->fd = syscall(__NR_io_uring_setup, entries, &p);
+    if (ring->fd < 0) return false;
+
+    ring->entries = p.sq_entries;
+    ring->sqLen = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    ring->cqLen = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    ring->sqesLen = p.sq_entries * sizeof(struct io_uring_sqe);
+
+    // -- newer kernels map both rings with one mmap()
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        if (ring->cqLen > ring->sqLen) ring->sqLen = ring->cqLen;
+        ring->cqLen = ring->sqLen;
+    }
+
+    ring->sq = mmap(NULL, ring->sqLen, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+            IORING_OFF_SQ_RING);
+    ring->cq = (p.features & IORING_FEAT_SINGLE_MMAP) ? ring->sq :
+            mmap(NULL, ring->cqLen, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+    ring->sqes = (struct io_uring_sqe *)mmap(NULL, ring->sqesLen, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+            ring->fd, IORING_OFF_SQES);
+
+    if (ring->sq == MAP_FAILED || ring->cq == MAP_FAILED || ring->sqes == MAP_FAILED) {
+        if (ring->sqes != MAP_FAILED) munmap(ring->sqes, ring->sqesLen);
+        if (ring->cq != MAP_FAILED && ring->cq != ring->sq) munmap(ring->cq, ring->cqLen);
+        if (ring->sq != MAP_FAILED) munmap(ring->sq, ring->sqLen);
+        close(ring->fd);
+        return false;
+    }
+
+    uint8_t *sq = (uint8_t *)ring->sq;
+    uint8_t *cq = (uint8_t *)ring->cq;
+
+    ring->sqHead = (unsigned *)(sq + p.sq_off.head);
+    ring->sqTail = (unsigned *)(sq + p.sq_off.tail);
+    ring->sqMask = (unsigned *)(sq + p.sq_off.ring_mask);
+    ring->sqArray = (unsigned *)(sq + p.sq_off.array);
+    ring->cqHead = (unsigned *)(cq + p.cq_off.head);
+    ring->cqTail = (unsigned *)(cq + p.cq_off.tail);
+    ring->cqMask = (unsigned *)(cq + p.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+
+    return true;
+}
+
+
+static void CloseRing(Ring *ring)
+{
+    munmap(ring->sqes, ring->sqesLen);
+    if (ring->cq != ring->sq) munmap(ring->cq, ring->cqLen);
+    munmap(ring->sq, ring->sqLen);
+    close(ring->fd);
+}
+
+
+
+//
+// -- Queue the writes [first, last) on the ring, submit them all and wait for every one; anything the ring did
+//    not finish is left for pwrite().  The kernel may take fewer entries than it is given, so the rest are
+//    submitted again until it stops taking them.  False if the ring itself failed, or some entries are still
+//    queued, so the ring is not used again.
+//    ---------------------------------------------------------------------------------------------------------
+static bool RingWrite(Ring *ring, const ImageWrite *writes, Pending *pending, int first, int last)
+{
+    unsigned tail = *ring->sqTail;
+    unsigned count = last - first;
+
+    for (int i = first; i < last; i ++) {
+        unsigned idx = tail & *ring->sqMask;
+        struct io_uring_sqe *sqe = &ring->sqes[idx];
+
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_WRITE;
+        sqe->fd = pending[i].fd;
+        sqe->addr = (uint64_t)(uintptr_t)writes[i].data;
+        sqe->len = writes[i].size;
+        sqe->off = 0;
+        sqe->user_data = i;
+
+        ring->sqArray[idx] = idx;
+        tail ++;
+    }
+
+    __atomic_store_n(ring->sqTail, tail, __ATOMIC_RELEASE);
+
+    unsigned submitted = 0;
+    int rv;
+
+    while (submitted < count) {
+        // -- the first also waits for them all (the kernel does not wait if it takes only some); any more only submit
+        unsigned wait = submitted == 0 ? count : 0;
+
+        do {
+            rv = syscall(__NR_io_uring_enter, ring->fd, count - submitted, wait, wait ? IORING_ENTER_GETEVENTS : 0,
+                    NULL, 0);
+        } while (rv < 0 && errno == EINTR);
+
+        if (rv <= 0) break;
+
+        submitted += rv;
+    }
+
+    if (submitted == 0) return false;
+
+
+    // -- reap a completion for every write submitted; a short or failed write is picked up by pwrite(), as is
+    //    any write which was never submitted
+    unsigned head = *ring->cqHead;
+    unsigned seen = 0;
+
+    while (seen < submitted) {
+        unsigned cqTail = __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE);
+
+        if (head == cqTail) {
+            do {
+                rv = syscall(__NR_io_uring_enter, ring->fd, 0, submitted - seen, IORING_ENTER_GETEVENTS, NULL, 0);
+            } while (rv < 0 && errno == EINTR);
+
+            if (rv < 0) return false;
+            continue;
+        }
+
+        struct io_uring_cqe *cqe = &ring->cqes[head & *ring->cqMask];
+
+        if (cqe->res > 0) pending[cqe->user_data].done = cqe->res;
+
+        head ++;
+        seen ++;
+        __atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+    }
+
+    return submitted == count;
+}
+
+#endif
+
+
+
+//
+// -- Write whatever is left of a file with pwrite()
+//    ----------------------------------------------
+static bool FinishWrite(const ImageWrite *write, Pending *pending)
+{
+    while (pending->done < write->size) {
+        ssize_t rv = pwrite(pending->fd, write->data + pending->done, write->size - pending->done, pending->done);
+
+        if (rv < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+
+        pending->done += rv;
+    }
+
+    return true;
+}
+
+
+
+//
+// -- Throw away the temporary files
+//    ------------------------------
+static void AbandonBatch(Pending *pending, int count)
+{
+    for (int i = 0; i < count; i ++) {
+        if (pending[i].fd >= 0) close(pending[i].fd);
+        unlink(pending[i].tmp);
+    }
+}
+
+
+
+//
+// -- Write every file in the batch through a temporary and rename them all into place
+//    --------------------------------------------------------------------------------
+bool WriteBatch(const ImageWrite *writes, int count)
+{
+    Pending *pending = (Pending *)calloc(count, sizeof(Pending));
+
+    if (!pending) {
+        fprintf(stderr, "Out of memory\n");
+        return false;
+    }
+
+
+    // -- open everything first
+    for (int i = 0; i < count; i ++) {
+        snprintf(pending[i].tmp, sizeof(pending[i].tmp), "%s.tmp", writes[i].path);
+
+        pending[i].fd = open(pending[i].tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+        if (pending[i].fd < 0) {
+            fprintf(stderr, "Unable to create %s: %s\n", pending[i].tmp, strerror(errno));
+            AbandonBatch(pending, i);
+            free(pending);
+            return false;
+        }
+    }
+
+
+    // -- then all the writes in one go, as far as the ring will take them
+#ifdef HAVE_IO_URING
+    Ring ring;
+
+    if (OpenRing(&ring, RING_ENTRIES)) {
+        for (int i = 0; i < count; i += ring.entries) {
+            int last = i + (int)ring.entries < count ? i + (int)ring.entries : count;
+
+            if (!RingWrite(&ring, writes, pending, i, last)) break;
+        }
+
+        CloseRing(&ring);
+    }
+#endif
+
+    for (int i = 0; i < count; i ++) {
+        if (!FinishWrite(&writes[i], &pending[i])) {
+            fprintf(stderr, "Unable to write %s: %s\n", pending[i].tmp, strerror(errno));
+            AbandonBatch(pending, count);
+            free(pending);
+            return false;
+        }
+    }
+
+
+    // -- and finally put them all in place
+    for (int i = 0; i < count; i ++) {
+        int rv = close(pending[i].fd);
+
+        pending[i].fd = -1;
+
+        if (rv != 0 || rename(pending[i].tmp, writes[i].path) != 0) {
+            fprintf(stderr, "Unable to finish %s: %s\n", writes[i].path, strerror(errno));
+            AbandonBatch(pending + i, count - i);
+            free(pending);
+            return false;
+        }
+    }
+
+    free(pending);
+
+    return true;
+}
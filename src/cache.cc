@@ -0,0 +1,260 @@
+//===================================================================================================================
+//  cache.cc -- Regenerate only the instructions whose microcode has changed since the last run
+//
+//  A hash of each instruction's decoded microcode is kept in `ctrl.hash` next to the images.  On the next run,
+//  the hashes are compared and only the addresses which belong to a changed instruction (one per flags bank) are
+//  worked out again, in a copy of the images.  The existing images are never written: only those which come out
+//  different are replaced, each through a temporary file renamed into place as for a full build, and when no
+//  instruction changed no image is touched at all (so nothing watching them is woken).  A hash of each image
+//  is kept too, so that if the images have been rewritten some other way since (or the hashes or any of the
+//  images are missing, or do not match the part size), everything is regenerated.
+//
+//  The hash file is always written last.  If a run is interrupted part way through, each image is either the old
+//  one or the new one, and the old hashes are still on disk, so the next run sees the images no longer match
+//  them and regenerates everything.
+//
+//  -----------------------------------------------------------------------------------------------------------------
+//
+//     Date      Tracker  Version  Pgmr  Description
+//  -----------  -------  -------  ----  ---------------------------------------------------------------------------
+//  2026-Oct-16  Initial  v0.0.1   ADCL  Initial version
+//  2026-Oct-16  Initial  v0.0.2   ADCL  Work from any decode table, not just the compiled-in one
+//  2026-Oct-16  Initial  v0.0.3   ADCL  Optionally write the programming plan for what changed
+//  2026-Oct-16  Initial  v0.0.4   ADCL  FNV-1a moves to crc.cc to be shared
+//
+//===================================================================================================================
+
+
+#include <cstdint>
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "eeprom.h"
+#include "microcode.h"
+
+
+
+//
+// -- The name of the hash file, and what is at the top of it
+//    -------------------------------------------------------
+const char *HASH_FILE = "ctrl.hash";
+const char HASH_MAGIC[8] = { 'C', 'T', 'R', 'L', 'H', 'A', 'S', 'H' };
+const uint32_t HASH_VERSION = 1;
+
+
+typedef struct HashFile {
+    char magic[8];
+    uint32_t version;
+    uint32_t size;                           // the part size the images were generated for
+    uint64_t image[CTRL_LANES];              // the hash of each image as it was left
+    uint64_t hash[INSTR_COUNT];              // the hash of each instruction's microcode
+} HashFile;
+
+
+
+//
+// -- Hash everything which goes into the EEPROM bytes for an instruction (field by field, to skip the padding)
+//    ---------------------------------------------------------------------------------------------------------
+static uint64_t HashOpcode(const OpcodeDesc &desc, uint128_t activeLow)
+{
+    uint64_t hash = FNV_OFFSET;
+
+    hash = Fnv1a(hash, &activeLow, sizeof(activeLow));
+    hash = Fnv1a(hash, &desc.met, sizeof(desc.met));
+    hash = Fnv1a(hash, &desc.notMet, sizeof(desc.notMet));
+    hash = Fnv1a(hash, &desc.flags, sizeof(desc.flags));
+    hash = Fnv1a(hash, &desc.immediate, sizeof(desc.immediate));
+
+    return hash;
+}
+
+
+
+//
+// -- Read the hashes from the last run; false if there are none we can use
+//    ---------------------------------------------------------------------
+static bool ReadHashes(const char *path, int size, HashFile *old)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    ssize_t got = read(fd, old, sizeof(HashFile));
+    close(fd);
+
+    return got == (ssize_t)sizeof(HashFile) && memcmp(old->magic, HASH_MAGIC, sizeof(HASH_MAGIC)) == 0 &&
+            old->version == HASH_VERSION && old->size == (uint32_t)size;
+}
+
+
+
+//
+// -- Map the existing images to read; false (with nothing left mapped) if any of them is unusable
+//    --------------------------------------------------------------------------------------------
+static bool MapExisting(const char *dir, int size, const uint8_t *lanes[CTRL_LANES])
+{
+    char path[FILENAME_MAX];
+    int l;
+
+    for (l = 0; l < CTRL_LANES; l ++) {
+        struct stat st;
+
+        LanePath(path, sizeof(path), dir, l);
+
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) break;
+
+        if (fstat(fd, &st) != 0 || st.st_size != size) {
+            close(fd);
+            break;
+        }
+
+        void *addr = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+
+        if (addr == MAP_FAILED) break;
+
+        lanes[l] = (const uint8_t *)addr;
+    }
+
+    if (l == CTRL_LANES) return true;
+
+    while (l > 0) munmap((void *)lanes[-- l], size);
+
+    return false;
+}
+
+
+
+//
+// -- Let go of the existing images
+//    -----------------------------
+static void UnmapExisting(const uint8_t *lanes[CTRL_LANES], int size)
+{
+    for (int l = 0; l < CTRL_LANES; l ++) munmap((void *)lanes[l], size);
+}
+
+
+
+//
+// -- Patch a copy of the existing images with the instructions which changed, and replace only the images which
+//    come out different; returns how many were replaced, or -1 on failure.  With `plan`, the pages which changed
+//    are planned against the existing images.
+//    -----------------------------------------------------------------------------------------------------------
+static int PatchImages(const OpcodeTable *table, const char *dir, int size,
+        const uint8_t *const existing[CTRL_LANES], const HashFile *cur, const HashFile *old, uint64_t hash[CTRL_LANES],
+        bool plan)
+{
+    char path[FILENAME_MAX];
+    uint8_t *lanes[CTRL_LANES];
+    int replaced = 0;
+
+    uint8_t *image = (uint8_t *)malloc((size_t)size * CTRL_LANES);
+
+    if (!image) {
+        fprintf(stderr, "Out of memory\n");
+        return -1;
+    }
+
+    for (int l = 0; l < CTRL_LANES; l ++) {
+        lanes[l] = image + (size_t)l * size;
+        memcpy(lanes[l], existing[l], size);
+    }
+
+    for (int i = 0; i < INSTR_COUNT; i ++) {
+        if (cur->hash[i] != old->hash[i]) ExpandInstructions(*table, lanes, size, i, i + 1);
+    }
+
+    if (plan && !WritePlans(dir, existing, lanes, size)) replaced = -1;
+
+    for (int l = 0; l < CTRL_LANES && replaced >= 0; l ++) {
+        hash[l] = Fnv1a(FNV_OFFSET, lanes[l], size);
+
+        if (memcmp(lanes[l], existing[l], size) == 0) continue;
+
+        LanePath(path, sizeof(path), dir, l);
+        replaced = WriteFileAtomic(path, lanes[l], size) ? replaced + 1 : -1;
+    }
+
+    free(image);
+
+    return replaced;
+}
+
+
+
+//
+// -- Bring the images in `dir` up to date, touching only what changed
+//    ----------------------------------------------------------------
+bool GenerateIncremental(const OpcodeTable *table, const char *dir, int size, int threads, bool plan)
+{
+    static HashFile cur;
+    static HashFile old;
+    char hashPath[FILENAME_MAX];
+    const uint8_t *existing[CTRL_LANES];
+    int changed = 0;
+
+    memcpy(cur.magic, HASH_MAGIC, sizeof(HASH_MAGIC));
+    cur.version = HASH_VERSION;
+    cur.size = size;
+
+    for (int i = 0; i < INSTR_COUNT; i ++) cur.hash[i] = HashOpcode(table->desc[i], table->activeLow);
+
+    if (dir && *dir) snprintf(hashPath, sizeof(hashPath), "%s/%s", dir, HASH_FILE);
+    else snprintf(hashPath, sizeof(hashPath), "%s", HASH_FILE);
+
+    bool usable = ReadHashes(hashPath, size, &old) && MapExisting(dir, size, existing);
+
+    // -- make sure nobody has rewritten the images behind our back
+    for (int l = 0; usable && l < CTRL_LANES; l ++) {
+        if (Fnv1a(FNV_OFFSET, existing[l], size) == old.image[l]) continue;
+
+        UnmapExisting(existing, size);
+        usable = false;
+    }
+
+    if (usable) {
+        for (int i = 0; i < INSTR_COUNT; i ++) changed += cur.hash[i] != old.hash[i];
+
+        // -- nothing to do, so leave the images exactly as they are (the plan is still written, and is empty)
+        if (changed == 0) {
+            bool ok = !plan || WritePlans(dir, existing, existing, size);
+
+            UnmapExisting(existing, size);
+            if (ok) printf("No instructions changed; nothing rewritten\n");
+            return ok;
+        }
+
+        int replaced = PatchImages(table, dir, size, existing, &cur, &old, cur.image, plan);
+
+        UnmapExisting(existing, size);
+
+        if (replaced < 0) return false;
+
+        printf("%d instruction(s) changed; %d of %d image(s) rewritten\n", changed, replaced, CTRL_LANES);
+    } else {
+        MappedImages map;
+
+        if (!MapImages(&map, dir, size)) return false;
+
+        GenerateParallel(table, map.lanes, size, threads);
+
+        for (int l = 0; l < CTRL_LANES; l ++) cur.image[l] = Fnv1a(FNV_OFFSET, map.lanes[l], size);
+
+        if (plan && !PlanAgainstFiles(dir, map.lanes, size)) {
+            AbandonImages(&map);
+            return false;
+        }
+
+        if (!CommitImages(&map)) return false;
+
+        printf("No usable hashes or images; all %d instructions regenerated\n", INSTR_COUNT);
+    }
+
+    return WriteFileAtomic(hashPath, (const uint8_t *)&cur, sizeof(cur));
+}
@@ -17,688 +17,529 @@
 //  2023-Mar-29  Initial  v0.0.6   ADCL  Add support for the `JMP <imm16>` instruction
 //  2023-May-13  Initial  v0.0.7   ADCL  Add support for the `CLC` and `STC` instructions
 //  2023-May-22  Initial  v0.0.8   ADCL  Expand the instr to 12 bits; eliminate the direct-wired main bus assert
+//  2026-Oct-16  Initial  v0.0.9   ADCL  Replace the decode switch with a table built from the microcode
+//  2026-Oct-16  Initial  v0.0.10  ADCL  Compute the entire image at compile time; this only dumps it now
+//  2026-Oct-16  Initial  v0.0.11  ADCL  Generate each instruction once per combination of the flags it depends on
+//  2026-Oct-16  Initial  v0.0.12  ADCL  Add multi-threaded runtime generation for larger parts
+//  2026-Oct-16  Initial  v0.0.13  ADCL  The image is stored lane-major only
+//  2026-Oct-16  Initial  v0.0.14  ADCL  Add `--check` to prove the runtime generator matches the compiled-in image
+//  2026-Oct-16  Initial  v0.0.15  ADCL  Write each image in one go and stop on the first failure
+//  2026-Oct-16  Initial  v0.0.16  ADCL  Add `--mmap` to generate straight into the image files and `--output`
+//  2026-Oct-16  Initial  v0.0.17  ADCL  Add `--incremental` to only regenerate the instructions which changed
+//  2026-Oct-16  Initial  v0.0.18  ADCL  Add `--microcode` to load the microcode from a text file, and `--watch`
+//  2026-Oct-16  Initial  v0.0.19  ADCL  Add `--plan` to list the pages which need to be reprogrammed
+//  2026-Oct-16  Initial  v0.0.20  ADCL  Add `--polarity` and `--auto-polarity`; record the mask in ctrl.polarity
+//  2026-Oct-16  Initial  v0.0.21  ADCL  Add `--ihex`, `--srec` and `--fill` to also write sparse text images
+//  2026-Oct-16  Initial  v0.0.22  ADCL  Add the `upload` and `fake-prom` subcommands
+//  2026-Oct-16  Initial  v0.0.23  ADCL  Add the `verify` subcommand
+//  2026-Oct-16  Initial  v0.0.24  ADCL  Add `--package` to write all the images into `ctrl.rom`, and `inspect`
+//  2026-Oct-16  Initial  v0.0.25  ADCL  Add `--store` to keep every build, and `history` to get them back
+//  2026-Oct-16  Initial  v0.0.26  ADCL  Add `--liveness` to report the bits which never change, and `--prune`
+//  2026-Oct-16  Initial  v0.0.27  ADCL  Add the `pack` subcommand
+//  2026-Oct-16  Initial  v0.0.28  ADCL  Add `--variants` to build many sets of images and write them in one batch
+//  2026-Oct-16  Initial  v0.0.29  ADCL  Add the `simulate` subcommand
+//  2026-Oct-16  Initial  v0.0.30  ADCL  Simulate from predecoded micro-ops; add `--reference` and `--time`
+//  2026-Oct-16  Initial  v0.0.31  ADCL  Add `--jit` to `simulate`
+//  2026-Oct-16  Initial  v0.0.32  ADCL  Add the `sweep` subcommand, which runs 16 machines in lockstep
+//  2026-Oct-16  Initial  v0.0.33  ADCL  Add the `regress` subcommand, which runs a corpus of programs on every cpu
 //
 //===================================================================================================================
 
 
 #include <cstdint>
 #include <stdio.h>
+#include <stdlib.h>
 #include <cstring>
+#include <ctype.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#include "eeprom.h"
+#include "rom-image.h"
+#include "rom-package.h"
 
 
-typedef __uint128_t uint128_t;
 
 //
-// -- These are the different flags which will change what an instruction will actually do
-//    ------------------------------------------------------------------------------------
-enum {
-    FLAG_CONDITION          = 0b100ul,        // The contition was not met
-};
+// -- The options for a run
+//    ---------------------
+typedef struct Options {
+    const char *dir;                         // where to write the images
+    const char *microcode;                   // the text microcode to load, or NULL for the compiled-in microcode
+    int size;                                // the part size
+    int threads;                             // the number of threads to generate with
+    bool runtime;                            // generate at runtime rather than dump the compiled-in image
+    bool mapped;                             // generate straight into the mapped files
+    bool incremental;                        // only regenerate what changed
+    bool plan;                               // write the pages which need to be programmed for each EEPROM
+    bool check;                              // check the runtime generator rather than write anything
+    bool watch;                              // keep regenerating whenever the microcode changes
+    bool polarity;                           // report the best active-low bits rather than write anything
+    bool autoPolarity;                       // generate with the best active-low bits
+    bool ihex;                               // also write the images as Intel HEX
+    bool srec;                               // also write the images as S-records
+    int fill;                                // the byte the text images leave out
+    bool package;                            // also write the package
+    const char *store;                       // also add the images to this store of builds
+    bool liveness;                           // report the bits which never change rather than write anything
+    bool prune;                              // remove the images of the EEPROMs which carry nothing
+    const char *variants;                    // build every set of images described in this file
+} Options;
+
 
 
 //
-// -- These are the different control signals which can be enabled on the PROM
-//    ------------------------------------------------------------------------
-enum : uint128_t {
-    //
-    // == CTRL1
-    //    =====
-
-    // bits 7:6 -- assert to Address Bus 1
-    ADDR_BUS_1_ASSERT_PC    = (((uint128_t)0b00ul)      << 6) << 0,
-    ADDR_BUS_1_ASSERT_RA    = (((uint128_t)0b01ul)      << 6) << 0,
-    ADDR_BUS_1_ASSERT_INTPC = (((uint128_t)0b10ul)      << 6) << 0,
-    ADDR_BUS_1_ASSERT_INTRA = (((uint128_t)0b11ul)      << 6) << 0,
-
-    // bit 5:0 -- assert to Main Bus
-    MAIN_NONE               = (((uint128_t)0b000000ul)  << 0) << 0,
-    MAIN_R1                 = (((uint128_t)0b000001ul)  << 0) << 0,
-    MAIN_R2                 = (((uint128_t)0b000010ul)  << 0) << 0,
-    MAIN_R3                 = (((uint128_t)0b000011ul)  << 0) << 0,
-    MAIN_R4                 = (((uint128_t)0b000100ul)  << 0) << 0,
-    MAIN_R5                 = (((uint128_t)0b000101ul)  << 0) << 0,
-    MAIN_R6                 = (((uint128_t)0b000110ul)  << 0) << 0,
-    MAIN_R7                 = (((uint128_t)0b000111ul)  << 0) << 0,
-    MAIN_R8                 = (((uint128_t)0b001000ul)  << 0) << 0,
-    MAIN_R9                 = (((uint128_t)0b001001ul)  << 0) << 0,
-    MAIN_R10                = (((uint128_t)0b001010ul)  << 0) << 0,
-    MAIN_R11                = (((uint128_t)0b001011ul)  << 0) << 0,
-    MAIN_R12                = (((uint128_t)0b001100ul)  << 0) << 0,
-    MAIN_SP                 = (((uint128_t)0b001101ul)  << 0) << 0,
-    MAIN_RA                 = (((uint128_t)0b001110ul)  << 0) << 0,
-    MAIN_PC                 = (((uint128_t)0b001111ul)  << 0) << 0,
-    MAIN_ISP                = (((uint128_t)0b010000ul)  << 0) << 0,
-    MAIN_IRA                = (((uint128_t)0b010001ul)  << 0) << 0,
-    MAIN_IPC                = (((uint128_t)0b010010ul)  << 0) << 0,
-    MAIN_FETCH              = (((uint128_t)0b010011ul)  << 0) << 0,
-    MAIN_DEV1               = (((uint128_t)0b010100ul)  << 0) << 0,
-    MAIN_DEV2               = (((uint128_t)0b010101ul)  << 0) << 0,
-    MAIN_DEV3               = (((uint128_t)0b010110ul)  << 0) << 0,
-    MAIN_DEV4               = (((uint128_t)0b010111ul)  << 0) << 0,
-    MAIN_DEV5               = (((uint128_t)0b011000ul)  << 0) << 0,
-    MAIN_DEV6               = (((uint128_t)0b011001ul)  << 0) << 0,
-    MAIN_DEV7               = (((uint128_t)0b011010ul)  << 0) << 0,
-    MAIN_DEV8               = (((uint128_t)0b011011ul)  << 0) << 0,
-    MAIN_DEV9               = (((uint128_t)0b011100ul)  << 0) << 0,
-    MAIN_DEV10              = (((uint128_t)0b011101ul)  << 0) << 0,
-    MAIN_ALU_ADDER          = (((uint128_t)0b011110ul)  << 0) << 0,
-    MAIN_MEMORY             = (((uint128_t)0b011111ul)  << 0) << 0,
-
-    MAIN_CTL1               = (((uint128_t)0b100100ul)  << 0) << 0,
-    MAIN_CTL2               = (((uint128_t)0b100101ul)  << 0) << 0,
-    MAIN_CTL3               = (((uint128_t)0b100110ul)  << 0) << 0,
-    MAIN_CTL4               = (((uint128_t)0b100111ul)  << 0) << 0,
-    MAIN_CTL5               = (((uint128_t)0b101000ul)  << 0) << 0,
-    MAIN_CTL6               = (((uint128_t)0b101001ul)  << 0) << 0,
-    MAIN_CTL7               = (((uint128_t)0b101010ul)  << 0) << 0,
-    MAIN_CTL8               = (((uint128_t)0b101011ul)  << 0) << 0,
-    MAIN_CTL9               = (((uint128_t)0b101100ul)  << 0) << 0,
-    MAIN_CTL10              = (((uint128_t)0b101101ul)  << 0) << 0,
-
-
-    //---------------------------------------------------
-
-    //
-    // == CTRL2
-    //    =====
-
-    // bits 7:6 -- PC Load/Inc/Dec
-    PC_DO_NOTHING           = (((uint128_t)0b00ul)      << 6) << 8,
-    PC_LOAD                 = (((uint128_t)0b01ul)      << 6) << 8,
-    PC_INC                  = (((uint128_t)0b10ul)      << 6) << 8,
-    PC_DEC                  = (((uint128_t)0b11ul)      << 6) << 8,
-
-    // bits 5:4 -- RA Load/Inc/Dec
-    RA_DO_NOTHING           = (((uint128_t)0b00ul)      << 4) << 8,
-    RA_LOAD                 = (((uint128_t)0b01ul)      << 4) << 8,
-    RA_INC                  = (((uint128_t)0b10ul)      << 4) << 8,
-    RA_DEC                  = (((uint128_t)0b11ul)      << 4) << 8,
-
-    // bits 3:2 -- SP Load/Inc/Dec
-    SP_DO_NOTHING           = (((uint128_t)0b00ul)      << 2) << 8,
-    SP_LOAD                 = (((uint128_t)0b01ul)      << 2) << 8,
-    SP_INC                  = (((uint128_t)0b10ul)      << 2) << 8,
-    SP_DEC                  = (((uint128_t)0b11ul)      << 2) << 8,
-
-    // bits 1:0 -- INT-PC Load/Inc/Dec
-    INT_PC_DO_NOTHING       = (((uint128_t)0b00ul)      << 0) << 8,
-    INT_PC_LOAD             = (((uint128_t)0b01ul)      << 0) << 8,
-    INT_PC_INC              = (((uint128_t)0b10ul)      << 0) << 8,
-    INT_PC_DEC              = (((uint128_t)0b11ul)      << 0) << 8,
-
-
-    //---------------------------------------------------
-
-    //
-    // == CTRL3
-    //    =====
-
-    // bits 7:6 -- INT-RA Load/Inc/Dec
-    INT_RA_DO_NOTHING       = (((uint128_t)0b00ul)      << 6) << 16,
-    INT_RA_LOAD             = (((uint128_t)0b01ul)      << 6) << 16,
-    INT_RA_INC              = (((uint128_t)0b10ul)      << 6) << 16,
-    INT_RA_DEC              = (((uint128_t)0b11ul)      << 6) << 16,
-
-    // bits 5:4 -- INT-SP Load/Inc/Dec
-    INT_SP_DO_NOTHING       = (((uint128_t)0b00ul)      << 4) << 16,
-    INT_SP_LOAD             = (((uint128_t)0b01ul)      << 4) << 16,
-    INT_SP_INC              = (((uint128_t)0b10ul)      << 4) << 16,
-    INT_SP_DEC              = (((uint128_t)0b11ul)      << 4) << 16,
-
-    // bit 3 -- Memory Write
-    MEMORY_NOTHING          = (((uint128_t)0b0ul)       << 3) << 16,
-    MEMORY_WRITE            = (((uint128_t)0b1ul)       << 3) << 16,
-
-    // bit 2 -- Fetch Assert to Instruction
-    INSTRUCTION_ASSERT      = (((uint128_t)0b0ul)       << 2) << 16,
-    INSTRUCTION_SUPPRESS    = (((uint128_t)0b1ul)       << 2) << 16,
-
-    // bit 1 -- R1 Load
-    R1_DO_NOTHING           = (((uint128_t)0b0ul)       << 1) << 16,
-    R1_LOAD                 = (((uint128_t)0b1ul)       << 1) << 16,
-
-    // bit 0 -- R2 Load
-    R2_DO_NOTHING           = (((uint128_t)0b0ul)       << 0) << 16,
-    R2_LOAD                 = (((uint128_t)0b1ul)       << 0) << 16,
-
-
-    //---------------------------------------------------
-
-    //
-    // == CTRL4
-    //    =====
-
-    // bit 7 -- R3 Load
-    R3_DO_NOTHING           = (((uint128_t)0b0ul)       << 7) << 24,
-    R3_LOAD                 = (((uint128_t)0b1ul)       << 7) << 24,
-
-    // bit 6 -- R4 Load
-    R4_DO_NOTHING           = (((uint128_t)0b0ul)       << 6) << 24,
-    R4_LOAD                 = (((uint128_t)0b1ul)       << 6) << 24,
+// -- The most sets of images one run will build from a `--variants` file
+//    -------------------------------------------------------------------
+const int MAX_VARIANTS = 64;
 
-    // bit 5 -- R5 Load
-    R5_DO_NOTHING           = (((uint128_t)0b0ul)       << 5) << 24,
-    R5_LOAD                 = (((uint128_t)0b1ul)       << 5) << 24,
 
-    // bit 4 -- R6 Load
-    R6_DO_NOTHING           = (((uint128_t)0b0ul)       << 4) << 24,
-    R6_LOAD                 = (((uint128_t)0b1ul)       << 4) << 24,
 
-    // bit 3 -- R7 Load
-    R7_DO_NOTHING           = (((uint128_t)0b0ul)       << 3) << 24,
-    R7_LOAD                 = (((uint128_t)0b1ul)       << 3) << 24,
+//
+// -- Tell the user how to run this
+//    -----------------------------
+static void Usage(const char *pgm)
+{
+    fprintf(stderr, "Usage: %s [--microcode <file> [--watch]] [--output <dir>] [--size <bytes>] [--threads <n>]\n",
+            pgm);
+    fprintf(stderr, "           [--mmap] [--incremental] [--plan] [--auto-polarity] [--ihex] [--srec]\n");
+    fprintf(stderr, "           [--fill <byte>] [--package] [--store <dir>] [--prune]\n");
+    fprintf(stderr, "       %s --variants <file> [--threads <n>] [--plan] [--ihex] [--srec] [--fill <byte>] [--package]\n",
+            pgm);
+    fprintf(stderr, "           [--store <dir>] [--prune]\n");
+    fprintf(stderr, "       %s [--microcode <file>] --check\n", pgm);
+    fprintf(stderr, "       %s [--microcode <file>] [--size <bytes>] --polarity\n", pgm);
+    fprintf(stderr, "       %s [--microcode <file>] [--size <bytes>] [--auto-polarity] --liveness\n", pgm);
+    fprintf(stderr, "       %s upload <tty> [--output <dir>] [--size <bytes>] [--plan] [--no-wait]\n", pgm);
+    fprintf(stderr, "       %s verify <tty>|<dump> [--lane <n>] [--output <dir>] [--size <bytes>] [--no-wait]\n", pgm);
+    fprintf(stderr, "       %s inspect <package>\n", pgm);
+    fprintf(stderr, "       %s history [list|checkout <build>|diff <build> [<build>]] [--store <dir>] [--output <dir>]\n",
+            pgm);
+    fprintf(stderr, "       %s pack <fields> [--header <file>] [--map <file>]\n", pgm);
+    fprintf(stderr, "       %s simulate <program> [--microcode <file> | --images <dir>] [--cycles <n>] [--at <addr>]\n"
+            "           [--trace | --reference | --jit] [--time]\n", pgm);
+    fprintf(stderr, "       %s sweep <program> --in R<n>[,R<n>...] [--random <n> [--seed <n>]] [--microcode <file> |\n"
+            "           --images <dir>] [--cycles <n>] [--at <addr>] [--table <file>] [--check]\n", pgm);
+    fprintf(stderr, "       %s regress <corpus> [--microcode <file> | --images <dir>] [--cycles <n>] [--threads <n>]\n"
+            "           [--jit] [--failures]\n", pgm);
+    fprintf(stderr, "       %s fake-prom [--size <bytes>] [--load <file>] [--save <file>] [--link <path>]\n", pgm);
+    fprintf(stderr, "  --microcode <file> generate at runtime from the text microcode in <file>\n");
+    fprintf(stderr, "  --watch           keep regenerating whenever the microcode file changes\n");
+    fprintf(stderr, "  --output <dir>    write the images into <dir> rather than the current directory\n");
+    fprintf(stderr, "  --size <bytes>    generate for a larger part at runtime (%d..%d, a power of 2)\n",
+            PROM_SIZE, MAX_PROM_SIZE);
+    fprintf(stderr, "  --threads <n>     generate at runtime using <n> threads (0 = one per cpu)\n");
+    fprintf(stderr, "  --mmap            generate at runtime straight into the mapped image files\n");
+    fprintf(stderr, "  --incremental     only regenerate the instructions which changed since the last run\n");
+    fprintf(stderr, "  --plan            write ctrlN.plan with the %d-byte pages which changed in each image\n",
+            EEPROM_PAGE_SIZE);
+    fprintf(stderr, "  --ihex            also write each image as Intel HEX (ctrlN.hex)\n");
+    fprintf(stderr, "  --srec            also write each image as S-records (ctrlN.srec)\n");
+    fprintf(stderr, "  --fill <byte>     leave runs of <byte> out of the text images (default 0xff)\n");
+    fprintf(stderr, "  --package         also write all the images and the instruction names into %s\n",
+            PACKAGE_FILE);
+    fprintf(stderr, "  --store <dir>     also keep the images in the store of builds in <dir> (`history` reads it)\n");
+    fprintf(stderr, "  --prune           remove the images of the EEPROMs which carry nothing, once the rest is done\n");
+    fprintf(stderr, "  --variants <file> build every set of images described in <file> and write them all at once\n");
+    fprintf(stderr, "  --check           check the runtime generator against the compiled-in image and the scalar\n"
+            "                    transpose at every size; write nothing\n");
+    fprintf(stderr, "  --polarity        report the active-low bits which make the most bytes 0xff; write nothing\n");
+    fprintf(stderr, "  --auto-polarity   generate at runtime with the active-low bits which make most bytes 0xff\n");
+    fprintf(stderr, "  --liveness        report the bits and EEPROMs which never change; write nothing\n");
+}
 
-    // bit 2 -- R8 Load
-    R8_DO_NOTHING           = (((uint128_t)0b0ul)       << 2) << 24,
-    R8_LOAD                 = (((uint128_t)0b1ul)       << 2) << 24,
 
-    // bit 1 -- R9 Load
-    R9_DO_NOTHING           = (((uint128_t)0b0ul)       << 1) << 24,
-    R9_LOAD                 = (((uint128_t)0b1ul)       << 1) << 24,
 
-    // bit 0 -- R10 Load
-    R10_DO_NOTHING          = (((uint128_t)0b0ul)       << 0) << 24,
-    R10_LOAD                = (((uint128_t)0b1ul)       << 0) << 24,
+//
+// -- Make sure the runtime generator produces exactly the compiled-in image (which the compiler built with the
+//    plain scalar code), so that every ctrl*.bin is bit-identical no matter which path produced it.  With text
+//    microcode, this also proves it is the same as the compiled-in microcode.  For every part size, the fast
+//    generator is also checked against the scalar transpose, which is otherwise never run where there is SSE2.
+//    ---------------------------------------------------------------------------------------------------------
+static bool SameImage(const char *what, int size, const uint8_t *const expected[CTRL_LANES],
+        const uint8_t *const generated[CTRL_LANES])
+{
+    for (int l = 0; l < CTRL_LANES; l ++) {
+        for (int i = 0; i < size; i ++) {
+            if (generated[l][i] != expected[l][i]) {
+                fprintf(stderr, "%s (%dKB) differs at 0x%05x: expected 0x%02x from %s, generated 0x%02x\n",
+                        laneFile[l], size / 1024, i, expected[l][i], what, generated[l][i]);
+                return false;
+            }
+        }
+    }
 
+    return true;
+}
 
-    //---------------------------------------------------
 
-    //
-    // == CTRL5
-    //    =====
+static int CheckGenerator(const OpcodeTable *table, int threads)
+{
+    uint8_t *image = (uint8_t *)malloc((size_t)MAX_PROM_SIZE * CTRL_LANES * 2);
+    uint8_t *fast[CTRL_LANES], *scalar[CTRL_LANES];
+    const uint8_t *compiled[CTRL_LANES];
+    bool ok = true;
+
+    if (!image) {
+        fprintf(stderr, "Out of memory\n");
+        return EXIT_FAILURE;
+    }
 
-    // bit 7 -- R11 Load
-    R11_DO_NOTHING          = (((uint128_t)0b0ul)       << 7) << 32,
-    R11_LOAD                = (((uint128_t)0b1ul)       << 7) << 32,
+    for (int size = PROM_SIZE; size <= MAX_PROM_SIZE; size *= 2) {
+        for (int l = 0; l < CTRL_LANES; l ++) {
+            fast[l] = image + (size_t)l * size;
+            scalar[l] = image + (size_t)(CTRL_LANES + l) * size;
+            compiled[l] = romImage.lane[l];
+        }
 
-    // bit 6 -- R12 Load
-    R12_DO_NOTHING          = (((uint128_t)0b0ul)       << 6) << 32,
-    R12_LOAD                = (((uint128_t)0b1ul)       << 6) << 32,
+        GenerateParallel(table, fast, size, threads);
+        GenerateScalar(table, scalar, size);
 
-    // bit 5 -- DEV01 Load
-    DEV01_DO_NOTHING        = (((uint128_t)0b0ul)       << 5) << 32,
-    DEV01_LOAD              = (((uint128_t)0b1ul)       << 5) << 32,
+        if (size == PROM_SIZE) ok = SameImage("the compiled-in image", size, compiled, fast) && ok;
 
-    // bit 4 -- CTL01 Load
-    CTL01_DO_NOTHING        = (((uint128_t)0b0ul)       << 4) << 32,
-    CTL01_LOAD              = (((uint128_t)0b1ul)       << 4) << 32,
+        ok = SameImage("the scalar transpose", size, scalar, fast) && ok;
+    }
 
-    // bit 3 -- DEV02 Load
-    DEV02_DO_NOTHING        = (((uint128_t)0b0ul)       << 3) << 32,
-    DEV02_LOAD              = (((uint128_t)0b1ul)       << 3) << 32,
+    free(image);
 
-    // bit 2 -- CTL02 Load
-    CTL02_DO_NOTHING        = (((uint128_t)0b0ul)       << 2) << 32,
-    CTL02_LOAD              = (((uint128_t)0b1ul)       << 2) << 32,
+    if (ok) printf("The runtime generator matches the compiled-in image and the scalar transpose at every size\n");
 
-    // bit 1 -- DEV03 Load
-    DEV03_DO_NOTHING        = (((uint128_t)0b0ul)       << 1) << 32,
-    DEV03_LOAD              = (((uint128_t)0b1ul)       << 1) << 32,
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
 
-    // bit 0 -- CTL03 Load
-    CTL03_DO_NOTHING        = (((uint128_t)0b0ul)       << 0) << 32,
-    CTL03_LOAD              = (((uint128_t)0b1ul)       << 0) << 32,
 
 
-    //---------------------------------------------------
+//
+// -- Generate the images in memory to find the best active-low bits; report them and/or use them for `table`
+//    -------------------------------------------------------------------------------------------------------
+static bool ChoosePolarity(const Options *opt, OpcodeTable *table)
+{
+    uint8_t *image = (uint8_t *)malloc((size_t)opt->size * CTRL_LANES);
+    uint8_t *lanes[CTRL_LANES];
 
-    //
-    // == CTRL6
-    //    =====
+    if (!image) {
+        fprintf(stderr, "Out of memory\n");
+        return false;
+    }
 
-    // bit 7 -- DEV04 Load
-    DEV04_DO_NOTHING        = (((uint128_t)0b0ul)       << 7) << 40,
-    DEV04_LOAD              = (((uint128_t)0b1ul)       << 7) << 40,
+    for (int l = 0; l < CTRL_LANES; l ++) lanes[l] = image + (size_t)l * opt->size;
 
-    // bit 6 -- CTL04 Load
-    CTL04_DO_NOTHING        = (((uint128_t)0b0ul)       << 6) << 40,
-    CTL04_LOAD              = (((uint128_t)0b1ul)       << 6) << 40,
+    GenerateParallel(table, lanes, opt->size, opt->threads);
+    uint128_t best = BestPolarity(lanes, opt->size, table->activeLow, opt->polarity);
 
-    // bit 5 -- DEV05 Load
-    DEV05_DO_NOTHING        = (((uint128_t)0b0ul)       << 5) << 40,
-    DEV05_LOAD              = (((uint128_t)0b1ul)       << 5) << 40,
+    if (opt->autoPolarity) table->activeLow = best;
 
-    // bit 4 -- CTL05 Load
-    CTL05_DO_NOTHING        = (((uint128_t)0b0ul)       << 4) << 40,
-    CTL05_LOAD              = (((uint128_t)0b1ul)       << 4) << 40,
+    free(image);
 
-    // bit 3 -- DEV06 Load
-    DEV06_DO_NOTHING        = (((uint128_t)0b0ul)       << 3) << 40,
-    DEV06_LOAD              = (((uint128_t)0b1ul)       << 3) << 40,
+    return true;
+}
 
-    // bit 2 -- CTL06 Load
-    CTL06_DO_NOTHING        = (((uint128_t)0b0ul)       << 2) << 40,
-    CTL06_LOAD              = (((uint128_t)0b1ul)       << 2) << 40,
 
-    // bit 1 -- DEV07 Load
-    DEV07_DO_NOTHING        = (((uint128_t)0b0ul)       << 1) << 40,
-    DEV07_LOAD              = (((uint128_t)0b1ul)       << 1) << 40,
 
-    // bit 0 -- CTL07 Load
-    CTL07_DO_NOTHING        = (((uint128_t)0b0ul)       << 0) << 40,
-    CTL07_LOAD              = (((uint128_t)0b1ul)       << 0) << 40,
+//
+// -- Generate the images in memory and report the bits and lanes which never change
+//    ------------------------------------------------------------------------------
+static bool ReportLiveness(const Options *opt, const OpcodeTable *table)
+{
+    uint8_t *image = (uint8_t *)malloc((size_t)opt->size * CTRL_LANES);
+    uint8_t *lanes[CTRL_LANES];
 
+    if (!image) {
+        fprintf(stderr, "Out of memory\n");
+        return false;
+    }
 
-    //---------------------------------------------------
+    for (int l = 0; l < CTRL_LANES; l ++) lanes[l] = image + (size_t)l * opt->size;
 
-    //
-    // == CTRL7
-    //    =====
+    GenerateParallel(table, lanes, opt->size, opt->threads);
+    LiveLanes(lanes, opt->size, true);
 
-    // bit 7 -- DEV08 Load
-    DEV08_DO_NOTHING        = (((uint128_t)0b0ul)       << 7) << 48,
-    DEV08_LOAD              = (((uint128_t)0b1ul)       << 7) << 48,
+    free(image);
 
-    // bit 6 -- CTL08 Load
-    CTL08_DO_NOTHING        = (((uint128_t)0b0ul)       << 6) << 48,
-    CTL08_LOAD              = (((uint128_t)0b1ul)       << 6) << 48,
+    return true;
+}
 
-    // bit 5 -- DEV09 Load
-    DEV09_DO_NOTHING        = (((uint128_t)0b0ul)       << 5) << 48,
-    DEV09_LOAD              = (((uint128_t)0b1ul)       << 5) << 48,
 
-    // bit 4 -- CTL09 Load
-    CTL09_DO_NOTHING        = (((uint128_t)0b0ul)       << 4) << 48,
-    CTL09_LOAD              = (((uint128_t)0b1ul)       << 4) << 48,
 
-    // bit 3 -- DEV10 Load
-    DEV10_DO_NOTHING        = (((uint128_t)0b0ul)       << 3) << 48,
-    DEV10_LOAD              = (((uint128_t)0b1ul)       << 3) << 48,
+//
+// -- Generate and write one set of images
+//    ------------------------------------
+static bool GenerateImages(const Options *opt, const OpcodeTable *table)
+{
+    // -- only regenerate what changed
+    if (opt->incremental) return GenerateIncremental(table, opt->dir, opt->size, opt->threads, opt->plan);
 
-    // bit 2 -- CTL10 Load
-    CTL10_DO_NOTHING        = (((uint128_t)0b0ul)       << 2) << 48,
-    CTL10_LOAD              = (((uint128_t)0b1ul)       << 2) << 48,
 
-    // bits 1:0 -- Unused for now
+    // -- the usual case: the image was built by the compiler
+    if (!opt->runtime) {
+        const uint8_t *const lanes[CTRL_LANES] = {
+            romImage.lane[0], romImage.lane[1], romImage.lane[2], romImage.lane[3], romImage.lane[ 4], romImage.lane[ 5],
+            romImage.lane[6], romImage.lane[7], romImage.lane[8], romImage.lane[9], romImage.lane[10], romImage.lane[11],
+        };
 
+        if (opt->plan && !PlanAgainstFiles(opt->dir, lanes, PROM_SIZE)) return false;
 
-    //---------------------------------------------------
+        return WriteImages(opt->dir, lanes, PROM_SIZE);
+    }
 
-    //
-    // == CTRL8
-    //    =====
 
-    // bit 7 -- Clear Carry Flag
-    CLC                     = (((uint128_t)0b1ul)       << 7) << 56,
+    // -- otherwise, build it here: either straight into the files...
+    if (opt->mapped) {
+        MappedImages map;
 
-    // bit 6 -- Set Carry Flag
-    STC                     = (((uint128_t)0b1ul)       << 6) << 56,
+        if (!MapImages(&map, opt->dir, opt->size)) return false;
 
-    // bit 5 -- Latch Z Flag (Pgm)
-    PGM_Z_LATCH             = (((uint128_t)0b1ul)       << 5) << 56,
+        GenerateParallel(table, map.lanes, opt->size, opt->threads);
 
-    // bit 4 -- Latch C Flag (Pgm)
-    PGM_C_LATCH             = (((uint128_t)0b1ul)       << 4) << 56,
+        if (opt->plan && !PlanAgainstFiles(opt->dir, map.lanes, opt->size)) {
+            AbandonImages(&map);
+            return false;
+        }
 
-    // bit 3 -- Latch N Flag (Pgm)
-    PGM_N_LATCH             = (((uint128_t)0b1ul)       << 3) << 56,
+        return CommitImages(&map);
+    }
 
-    // bit 2 -- Latch V Flag (Pgm)
-    PGM_V_LATCH             = (((uint128_t)0b1ul)       << 2) << 56,
 
-    // bit 1 -- Latch L Flag (Pgm)
-    PGM_L_LATCH             = (((uint128_t)0b1ul)       << 1) << 56,
+    // -- ... or into memory; all the lanes are carved from one block
+    uint8_t *image = (uint8_t *)malloc((size_t)opt->size * CTRL_LANES);
+    uint8_t *lanes[CTRL_LANES];
 
-    // bit 0 -- ALU Input Latch
-    ALU_INPUT_LATCH         = (((uint128_t)0b1ul)       << 0) << 56,
+    if (!image) {
+        fprintf(stderr, "Out of memory\n");
+        return false;
+    }
 
+    for (int l = 0; l < CTRL_LANES; l ++) lanes[l] = image + (size_t)l * opt->size;
 
-    //---------------------------------------------------
+    GenerateParallel(table, lanes, opt->size, opt->threads);
+    bool ok = (!opt->plan || PlanAgainstFiles(opt->dir, lanes, opt->size)) && WriteImages(opt->dir, lanes, opt->size);
 
-    //
-    // == CTRL9
-    //    =====
+    free(image);
 
-    // bit 7:6 -- Carry Select
-    CARRY_0                 = (((uint128_t)0b00ul)      << 6) << 64,
-    CARRY_LAST              = (((uint128_t)0b01ul)      << 6) << 64,
-    CARRY_INVERTED          = (((uint128_t)0b10ul)      << 6) << 64,
-    CARRY_1                 = (((uint128_t)0b11ul)      << 6) << 64,
+    return ok;
+}
 
-    // bit 5 -- Latch Z Flag (Pgm)
-    INT_Z_LATCH             = (((uint128_t)0b1ul)       << 5) << 64,
 
-    // bit 4 -- Latch C Flag (Pgm)
-    INT_C_LATCH             = (((uint128_t)0b1ul)       << 4) << 64,
 
-    // bit 3 -- Latch N Flag (Pgm)
-    INT_N_LATCH             = (((uint128_t)0b1ul)       << 3) << 64,
+//
+// -- Once the images are written: the active-low mask they were made with, the text images, the package and the
+//    store from them, and finally prune the images which carry nothing
+//    ----------------------------------------------------------------------------------------------------------
+static bool FinishImages(const Options *opt, uint128_t activeLow)
+{
+    if (!WritePolarity(opt->dir, activeLow)) return false;
 
-    // bit 2 -- Latch V Flag (Pgm)
-    INT_V_LATCH             = (((uint128_t)0b1ul)       << 2) << 64,
+    if (opt->ihex && !WriteRecords(opt->dir, opt->size, RECORDS_IHEX, opt->fill)) return false;
+    if (opt->srec && !WriteRecords(opt->dir, opt->size, RECORDS_SREC, opt->fill)) return false;
 
-    // bit 1 -- Latch L Flag (Pgm)
-    INT_L_LATCH             = (((uint128_t)0b1ul)       << 1) << 64,
+    const char *source = opt->microcode ? opt->microcode : "compiled-in";
 
-    // bit 0 -- Unused for now
+    if (opt->package && !WritePackage(opt->dir, opt->size, source, activeLow)) return false;
+    if (opt->store && !StoreImages(opt->store, opt->dir, opt->size, source, activeLow)) return false;
 
+    if (opt->prune && !PruneImages(opt->dir, opt->size)) return false;
 
-    //---------------------------------------------------
+    return true;
+}
 
 
 
-    //
-    // == CTRL10
-    //    ======
+//
+// -- Generate and write one set of images, and everything else that goes with them
+//    -----------------------------------------------------------------------------
+static bool Generate(const Options *opt, const OpcodeTable *table)
+{
+    return GenerateImages(opt, table) && FinishImages(opt, table->activeLow);
+}
 
-    // bit 7:4 -- ALU A Assert
-    ALUA_NONE               = (((uint128_t)0b0000ul)    << 4) << 72,
-    ALUA_R1                 = (((uint128_t)0b0001ul)    << 4) << 72,
-    ALUA_R2                 = (((uint128_t)0b0010ul)    << 4) << 72,
-    ALUA_R3                 = (((uint128_t)0b0011ul)    << 4) << 72,
-    ALUA_R4                 = (((uint128_t)0b0100ul)    << 4) << 72,
-    ALUA_R5                 = (((uint128_t)0b0101ul)    << 4) << 72,
-    ALUA_R6                 = (((uint128_t)0b0110ul)    << 4) << 72,
-    ALUA_R7                 = (((uint128_t)0b0111ul)    << 4) << 72,
-    ALUA_R8                 = (((uint128_t)0b1000ul)    << 4) << 72,
-    ALUA_R9                 = (((uint128_t)0b1001ul)    << 4) << 72,
-    ALUA_R10                = (((uint128_t)0b1010ul)    << 4) << 72,
-    ALUA_R11                = (((uint128_t)0b1011ul)    << 4) << 72,
-    ALUA_R12                = (((uint128_t)0b1100ul)    << 4) << 72,
-    ALUA_PGM_SP             = (((uint128_t)0b1101ul)    << 4) << 72,
-    ALUA_INT_SP             = (((uint128_t)0b1110ul)    << 4) << 72,
 
-    // bit 3:0 -- ALU B Assert
-    ALUB_NONE               = (((uint128_t)0b0000ul)    << 0) << 72,
-    ALUB_R1                 = (((uint128_t)0b0001ul)    << 0) << 72,
-    ALUB_R2                 = (((uint128_t)0b0010ul)    << 0) << 72,
-    ALUB_R3                 = (((uint128_t)0b0011ul)    << 0) << 72,
-    ALUB_R4                 = (((uint128_t)0b0100ul)    << 0) << 72,
-    ALUB_R5                 = (((uint128_t)0b0101ul)    << 0) << 72,
-    ALUB_R6                 = (((uint128_t)0b0110ul)    << 0) << 72,
-    ALUB_R7                 = (((uint128_t)0b0111ul)    << 0) << 72,
-    ALUB_R8                 = (((uint128_t)0b1000ul)    << 0) << 72,
-    ALUB_R9                 = (((uint128_t)0b1001ul)    << 0) << 72,
-    ALUB_R10                = (((uint128_t)0b1010ul)    << 0) << 72,
-    ALUB_R11                = (((uint128_t)0b1011ul)    << 0) << 72,
-    ALUB_R12                = (((uint128_t)0b1100ul)    << 0) << 72,
-    ALUB_FETCH              = (((uint128_t)0b1101ul)    << 0) << 72,
-    ALUB_MEM                = (((uint128_t)0b1110ul)    << 0) << 72,
 
+//
+// -- Read the sets of images to build from a `--variants` file, one to a line:
+//
+//        <output dir>  <size>  <microcode file, or `-` for the compiled-in microcode>  <`auto` polarity, or `-`>
+//
+//    Anything from a `#` to the end of the line is a comment.  Each variant starts as a copy of `opt`.
+//    -----------------------------------------------------------------------------------------------------------
+static int LoadVariants(const Options *opt, Options *variants, char (*text)[FILENAME_MAX])
+{
+    char line[FILENAME_MAX];
+    int lineNo = 0;
+    int count = 0;
 
-    //---------------------------------------------------
+    FILE *fp = fopen(opt->variants, "r");
 
+    if (!fp) {
+        fprintf(stderr, "Unable to open %s: %s\n", opt->variants, strerror(errno));
+        return -1;
+    }
 
-    //
-    // == Improve code readability
-    //    ========================
-    FETCH_ASSERT_MAIN       = MAIN_FETCH | INSTRUCTION_SUPPRESS,
-};
+    while (fgets(line, sizeof(line), fp)) {
+        char dir[FILENAME_MAX], microcode[FILENAME_MAX], polarity[16];
+        int size;
+
+        lineNo ++;
+
+        char *hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+
+        char *p = line;
+        while (*p && isspace((unsigned char)*p)) p ++;
+        if (!*p) continue;
+
+        if (sscanf(line, "%4095s %i %4095s %15s", dir, &size, microcode, polarity) != 4 ||
+                (strcmp(polarity, "auto") != 0 && strcmp(polarity, "-") != 0)) {
+            fprintf(stderr, "%s:%d: expected <output dir> <size> <microcode|-> <auto|->\n", opt->variants, lineNo);
+            fclose(fp);
+            return -1;
+        }
+
+        if (size < PROM_SIZE || size > MAX_PROM_SIZE || (size & (size - 1)) != 0) {
+            fprintf(stderr, "%s:%d: unsupported part size %d\n", opt->variants, lineNo, size);
+            fclose(fp);
+            return -1;
+        }
+
+        if (count == MAX_VARIANTS) {
+            fprintf(stderr, "%s:%d: no more than %d variants\n", opt->variants, lineNo, MAX_VARIANTS);
+            fclose(fp);
+            return -1;
+        }
+
+        Options *v = &variants[count];
+
+        *v = *opt;
+        strcpy(text[count * 2], dir);
+        strcpy(text[count * 2 + 1], microcode);
+        v->dir = text[count * 2];
+        v->microcode = strcmp(microcode, "-") == 0 ? NULL : text[count * 2 + 1];
+        v->size = size;
+        v->autoPolarity = strcmp(polarity, "auto") == 0;
+        v->variants = NULL;
+        count ++;
+    }
 
+    fclose(fp);
 
-//
-// -- This #define should help readability in the code
-//    since a '1' on that flag means that the condition was not met
-//    -------------------------------------------------------------
-#define CONDITION_MET(x) (((x) & FLAG_CONDITION) == 0)
+    return count;
+}
 
 
 
 //
-// -- These are the instructions which will be encoded
-//
-//    Recall that the instruction word has the following format:
-//
-//              CCCC IIII IIII IIII
-//
-//    Where:
-//    - CCCC are control flags, used to condition the instruction
-//    - IIII IIII IIII is the instruction, encoded in the enum below
-//    --------------------------------------------------------------
-#include "opcodes.h"
+// -- Build every variant in memory, then write all of their images in one batch, and then the rest for each
+//    ------------------------------------------------------------------------------------------------------
+static int GenerateVariants(const Options *opt)
+{
+    static Options variants[MAX_VARIANTS];
+    static char text[MAX_VARIANTS * 2][FILENAME_MAX];
+    static ImageWrite writes[MAX_VARIANTS * CTRL_LANES];
+    static char paths[MAX_VARIANTS * CTRL_LANES][FILENAME_MAX];
+    static uint128_t activeLow[MAX_VARIANTS];
+    uint8_t *images[MAX_VARIANTS] = {};
+    OpcodeTable *table = (OpcodeTable *)malloc(sizeof(OpcodeTable));
+    int count = LoadVariants(opt, variants, text);
+    bool ok = table && count >= 0;
+
+    if (!table) fprintf(stderr, "Out of memory\n");
+
+    for (int v = 0; ok && v < count; v ++) {
+        Options *var = &variants[v];
+        uint8_t *lanes[CTRL_LANES];
+
+        // -- the microcode and the polarity for this one
+        if (var->microcode) ok = LoadMicrocode(var->microcode, table);
+        else *table = opcodeTable;
+
+        if (ok && var->autoPolarity) ok = ChoosePolarity(var, table);
+        if (!ok) break;
+
+        activeLow[v] = table->activeLow;
+
+        images[v] = (uint8_t *)malloc((size_t)var->size * CTRL_LANES);
+
+        if (!images[v]) {
+            fprintf(stderr, "Out of memory\n");
+            ok = false;
+            break;
+        }
+
+        for (int l = 0; l < CTRL_LANES; l ++) lanes[l] = images[v] + (size_t)l * var->size;
+
+        GenerateParallel(table, lanes, var->size, var->threads);
+
+        if (mkdir(var->dir, 0755) != 0 && errno != EEXIST) {
+            fprintf(stderr, "Unable to create %s: %s\n", var->dir, strerror(errno));
+            ok = false;
+            break;
+        }
+
+        if (var->plan && !PlanAgainstFiles(var->dir, lanes, var->size)) {
+            ok = false;
+            break;
+        }
+
+        for (int l = 0; l < CTRL_LANES; l ++) {
+            ImageWrite *w = &writes[v * CTRL_LANES + l];
+
+            LanePath(paths[v * CTRL_LANES + l], FILENAME_MAX, var->dir, l);
+            w->path = paths[v * CTRL_LANES + l];
+            w->data = lanes[l];
+            w->size = var->size;
+        }
+    }
 
+    ok = ok && WriteBatch(writes, count * CTRL_LANES);
 
-//
-// -- the size of the eeprom
-//    ----------------------
-const int PROM_SIZE = 1024 * 32;         // we are using 32KB EEPROM
+    for (int v = 0; v < count; v ++) free(images[v]);
+    free(table);
 
+    for (int v = 0; ok && v < count; v ++) ok = FinishImages(&variants[v], activeLow[v]);
+
+    if (ok) printf("%d variant(s), %d image(s) written\n", count, count * CTRL_LANES);
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
 
-//
-// -- this eeprom buffer(s)
-//    ---------------------
-uint128_t promBuffer [PROM_SIZE];
 
 
 //
-// -- Break the prom location down to the flags and instruction portions
-//    and determine the control lines for each possible combination
-//    ------------------------------------------------------------------
-uint128_t GenerateControlSignals(int loc)
+// -- Keep regenerating whenever the microcode file changes; this only returns if the file cannot be watched
+//    ------------------------------------------------------------------------------------------------------
+static int Watch(const Options *opt)
 {
-    int flags = (loc >> 12) & 0x7;           // top 3 bits of the memory address; flags for augmenting the control signals
-    int instr = (loc >>  0) & 0xfff;         // bottom 12 bits for the memory address of the instruction
+    static OpcodeTable table;
+    struct timespec last = { 0, 0 };
+    const struct timespec poll = { 0, 100 * 1000 * 1000 };
+
+    while (true) {
+        struct stat st;
+
+        if (stat(opt->microcode, &st) != 0) {
+            fprintf(stderr, "Unable to watch %s: %s\n", opt->microcode, strerror(errno));
+            return EXIT_FAILURE;
+        }
 
-    const uint128_t nop = ADDR_BUS_1_ASSERT_PC |  PC_INC; // Note that `| INSTRUCTION_ASSERT` == `| 0`, ∴ omitted
-    uint128_t out = ADDR_BUS_1_ASSERT_PC | PC_INC;
-
-    switch (instr) {
-    default:
-    case OPCODE_NOP:
-        return nop;
+        if (st.st_mtim.tv_sec != last.tv_sec || st.st_mtim.tv_nsec != last.tv_nsec) {
+            struct timespec start, end;
 
-    case OPCODE_MOV_R1___16_:
-        //
-        // -- If we do not meet the condition, we do nothing and skip the next
-        //    word in the instruction stream since it is a constant value
-        //    ----------------------------------------------------------------
-        if (!CONDITION_MET(flags)) return nop | INSTRUCTION_SUPPRESS;
-
-        return out | FETCH_ASSERT_MAIN | R1_LOAD;
-
-    case OPCODE_MOV_R2___16_:
-        //
-        // -- If we do not meet the condition, we do nothing and skip the next
-        //    word in the instruction stream since it is a constant value
-        //    ----------------------------------------------------------------
-        if (!CONDITION_MET(flags)) return nop | INSTRUCTION_SUPPRESS;
-
-        return out | FETCH_ASSERT_MAIN | R2_LOAD;
-
-    case OPCODE_MOV_R1_RZ:
-        //
-        // -- If we do not meet the condition, we do nothing
-        //    ----------------------------------------------
-        if (!CONDITION_MET(flags)) return nop;
-
-        return out | MAIN_NONE | R1_LOAD;
-
-
-    case OPCODE_MOV_R2_RZ:
-        //
-        // -- If we do not meet the condition, we do nothing
-        //    ----------------------------------------------
-        if (!CONDITION_MET(flags)) return nop;
-
-        return out | MAIN_NONE | R2_LOAD;
-
-
-    case OPCODE_MOV_R2_R1:
-        //
-        // -- If we do not meet the condition, we do nothing
-        //    ----------------------------------------------
-        if (!CONDITION_MET(flags)) return nop;
-
-        return out | MAIN_R1 | R2_LOAD;
-
-    case OPCODE_MOV_R1_R2:
-        //
-        // -- If we do not meet the condition, we do nothing
-        //    ----------------------------------------------
-        if (!CONDITION_MET(flags)) return nop;
-
-        return out | MAIN_R2 | R1_LOAD;
-
-    case OPCODE_ADD_R1___16_:
-        //
-        // -- If we do not meet the condition, we do nothing and skip the next
-        //    word in the instruction stream since it is a constant value
-        //    ----------------------------------------------------------------
-        if (!CONDITION_MET(flags)) return nop | INSTRUCTION_SUPPRESS;
-
-        return CARRY_0 | ALUA_R1 | ALUB_FETCH | MAIN_ALU_ADDER | R1_LOAD | PGM_Z_LATCH | PGM_C_LATCH |
-                PGM_N_LATCH | PGM_V_LATCH | PGM_L_LATCH | ALU_INPUT_LATCH;
-
-    case OPCODE_ADD_R2___16_:
-        //
-        // -- If we do not meet the condition, we do nothing and skip the next
-        //    word in the instruction stream since it is a constant value
-        //    ----------------------------------------------------------------
-        if (!CONDITION_MET(flags)) return nop | INSTRUCTION_SUPPRESS;
-
-        return CARRY_0 | ALUA_R2 | ALUB_FETCH | MAIN_ALU_ADDER | R2_LOAD | PGM_Z_LATCH | PGM_C_LATCH |
-                PGM_N_LATCH | PGM_V_LATCH | PGM_L_LATCH | ALU_INPUT_LATCH;
-
-    case OPCODE_ADD_R1_R1:
-        //
-        // -- If we do not meet the condition, we do nothing
-        //    ----------------------------------------------
-        if (!CONDITION_MET(flags)) return nop;
-
-        return CARRY_0 | ALUA_R1 | ALUB_R1 | MAIN_ALU_ADDER | R1_LOAD | PGM_Z_LATCH | PGM_C_LATCH |
-                PGM_N_LATCH | PGM_V_LATCH | PGM_L_LATCH | ALU_INPUT_LATCH;
-
-    case OPCODE_ADD_R1_R2:
-        //
-        // -- If we do not meet the condition, we do nothing
-        //    ----------------------------------------------
-        if (!CONDITION_MET(flags)) return nop;
-
-        return CARRY_0 | ALUA_R1 | ALUB_R2 | MAIN_ALU_ADDER | R1_LOAD | PGM_Z_LATCH | PGM_C_LATCH |
-                PGM_N_LATCH | PGM_V_LATCH | PGM_L_LATCH | ALU_INPUT_LATCH;
-
-    case OPCODE_ADD_R2_R1:
-        //
-        // -- If we do not meet the condition, we do nothing
-        //    ----------------------------------------------
-        if (!CONDITION_MET(flags)) return nop;
-
-        return CARRY_0 | ALUA_R2 | ALUB_R1 | MAIN_ALU_ADDER | R2_LOAD | PGM_Z_LATCH | PGM_C_LATCH |
-                PGM_N_LATCH | PGM_V_LATCH | PGM_L_LATCH | ALU_INPUT_LATCH;
-
-    case OPCODE_ADD_R2_R2:
-        //
-        // -- If we do not meet the condition, we do nothing
-        //    ----------------------------------------------
-        if (!CONDITION_MET(flags)) return nop;
-
-        return CARRY_0 | ALUA_R2 | ALUB_R2 | MAIN_ALU_ADDER | R2_LOAD | PGM_Z_LATCH | PGM_C_LATCH |
-                PGM_N_LATCH | PGM_V_LATCH | PGM_L_LATCH | ALU_INPUT_LATCH;
-
-    case OPCODE_ADC_R1___16_:
-        //
-        // -- If we do not meet the condition, we do nothing and skip the next
-        //    word in the instruction stream since it is a constant value
-        //    ----------------------------------------------------------------
-        if (!CONDITION_MET(flags)) return nop | INSTRUCTION_SUPPRESS;
-
-        return CARRY_LAST | ALUA_R1 | ALUB_FETCH | MAIN_ALU_ADDER | R1_LOAD | PGM_Z_LATCH | PGM_C_LATCH |
-                PGM_N_LATCH | PGM_V_LATCH | PGM_L_LATCH | ALU_INPUT_LATCH;
-
-    case OPCODE_ADC_R2___16_:
-        //
-        // -- If we do not meet the condition, we do nothing and skip the next
-        //    word in the instruction stream since it is a constant value
-        //    ----------------------------------------------------------------
-        if (!CONDITION_MET(flags)) return nop | INSTRUCTION_SUPPRESS;
-
-        return CARRY_LAST | ALUA_R2 | ALUB_FETCH | MAIN_ALU_ADDER | R2_LOAD | PGM_Z_LATCH | PGM_C_LATCH |
-                PGM_N_LATCH | PGM_V_LATCH | PGM_L_LATCH | ALU_INPUT_LATCH;
-
-    case OPCODE_ADC_R1_R1:
-        //
-        // -- If we do not meet the condition, we do nothing
-        //    ----------------------------------------------
-        if (!CONDITION_MET(flags)) return nop;
-
-        return CARRY_LAST | ALUA_R1 | ALUB_R1 | MAIN_ALU_ADDER | R1_LOAD | PGM_Z_LATCH | PGM_C_LATCH |
-                PGM_N_LATCH | PGM_V_LATCH | PGM_L_LATCH | ALU_INPUT_LATCH;
-
-    case OPCODE_ADC_R1_R2:
-        //
-        // -- If we do not meet the condition, we do nothing
-        //    ----------------------------------------------
-        if (!CONDITION_MET(flags)) return nop;
-
-        return CARRY_LAST | ALUA_R1 | ALUB_R2 | MAIN_ALU_ADDER | R1_LOAD | PGM_Z_LATCH | PGM_C_LATCH |
-                PGM_N_LATCH | PGM_V_LATCH | PGM_L_LATCH | ALU_INPUT_LATCH;
-
-    case OPCODE_ADC_R2_R1:
-        //
-        // -- If we do not meet the condition, we do nothing
-        //    ----------------------------------------------
-        if (!CONDITION_MET(flags)) return nop;
-
-        return CARRY_LAST | ALUA_R2 | ALUB_R1 | MAIN_ALU_ADDER | R2_LOAD | PGM_Z_LATCH | PGM_C_LATCH |
-                PGM_N_LATCH | PGM_V_LATCH | PGM_L_LATCH | ALU_INPUT_LATCH;
-
-    case OPCODE_ADC_R2_R2:
-        //
-        // -- If we do not meet the condition, we do nothing
-        //    ----------------------------------------------
-        if (!CONDITION_MET(flags)) return nop;
-
-        return CARRY_LAST | ALUA_R2 | ALUB_R2 | MAIN_ALU_ADDER | R2_LOAD | PGM_Z_LATCH | PGM_C_LATCH |
-                PGM_N_LATCH | PGM_V_LATCH | PGM_L_LATCH | ALU_INPUT_LATCH;
-
-    case OPCODE_INC_R1:
-        //
-        // -- If we do not meet the condition, we do nothing
-        //    ----------------------------------------------
-        if (!CONDITION_MET(flags)) return nop;
-
-        return CARRY_1 | ALUA_R1 | ALUB_NONE | MAIN_ALU_ADDER | R1_LOAD | PGM_Z_LATCH | PGM_C_LATCH |
-                PGM_N_LATCH | PGM_V_LATCH | PGM_L_LATCH | ALU_INPUT_LATCH;
-
-    case OPCODE_INC_R2:
-        //
-        // -- If we do not meet the condition, we do nothing
-        //    ----------------------------------------------
-        if (!CONDITION_MET(flags)) return nop;
-
-        return CARRY_1 | ALUA_R2 | ALUB_NONE | MAIN_ALU_ADDER | R2_LOAD | PGM_Z_LATCH | PGM_C_LATCH |
-                PGM_N_LATCH | PGM_V_LATCH | PGM_L_LATCH | ALU_INPUT_LATCH;
-
-    case OPCODE_JMP___16_:
-        //
-        // -- If we do not meet the condition, we do nothing and skip the next
-        //    word in the instruction stream since it is a constant value
-        //    ----------------------------------------------------------------
-        if (!CONDITION_MET(flags)) return nop | INSTRUCTION_SUPPRESS;
-
-        return FETCH_ASSERT_MAIN | PC_LOAD | INSTRUCTION_SUPPRESS | ADDR_BUS_1_ASSERT_PC;
-
-    case OPCODE_JMP_R1:
-        //
-        // -- If we do not meet the condition, we do nothing
-        //    ----------------------------------------------
-        if (!CONDITION_MET(flags)) return nop;
-
-        return MAIN_R1 | PC_LOAD | INSTRUCTION_SUPPRESS | ADDR_BUS_1_ASSERT_PC;
-
-    case OPCODE_JMP_R2:
-        //
-        // -- If we do not meet the condition, we do nothing
-        //    ----------------------------------------------
-        if (!CONDITION_MET(flags)) return nop;
-
-        return MAIN_R2 | PC_LOAD | INSTRUCTION_SUPPRESS | ADDR_BUS_1_ASSERT_PC;
-
-    case OPCODE_CLC:
-        //
-        // -- If we do not meet the condition, we do nothing
-        //    ----------------------------------------------
-        if (!CONDITION_MET(flags)) return nop;
-
-        return out | CLC;
-
-    case OPCODE_STC:
-        //
-        // -- If we do not meet the condition, we do nothing
-        //    ----------------------------------------------
-        if (!CONDITION_MET(flags)) return nop;
-
-        return out | STC;
+            last = st.st_mtim;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+
+            if (LoadMicrocode(opt->microcode, &table) && (!opt->autoPolarity || ChoosePolarity(opt, &table)) &&
+                    Generate(opt, &table)) {
+                clock_gettime(CLOCK_MONOTONIC, &end);
+                printf("%s: images regenerated in %.1f ms\n", opt->microcode,
+                        (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6);
+            } else {
+                printf("%s: images not regenerated; waiting for the next change\n", opt->microcode);
+            }
+
+            fflush(stdout);
+        }
+
+        nanosleep(&poll, NULL);
     }
 }
 
@@ -707,122 +548,140 @@ uint128_t GenerateControlSignals(int loc)
 //
 // -- Main entry point
 //    ----------------
-int main(void)
+int main(int argc, char *argv[])
 {
 //    printf("CARRY_1 is %16.16lx%16.16lx\n", (uint64_t)(CARRY_1>>64), (uint64_t)CARRY_1);
 
-    for (int i = 0; i < PROM_SIZE; i ++) {
-        promBuffer[i] = GenerateControlSignals(i);
+    static OpcodeTable loaded;
+    Options opt = {};
+
+    // -- the subcommands have their own arguments
+    if (argc > 1 && strcmp(argv[1], "upload") == 0) return Upload(argv[0], argc - 2, argv + 2);
+    if (argc > 1 && strcmp(argv[1], "verify") == 0) return Verify(argv[0], argc - 2, argv + 2);
+    if (argc > 1 && strcmp(argv[1], "inspect") == 0) return Inspect(argv[0], argc - 2, argv + 2);
+    if (argc > 1 && strcmp(argv[1], "history") == 0) return History(argv[0], argc - 2, argv + 2);
+    if (argc > 1 && strcmp(argv[1], "pack") == 0) return Pack(argv[0], argc - 2, argv + 2);
+    if (argc > 1 && strcmp(argv[1], "simulate") == 0) return Simulate(argv[0], argc - 2, argv + 2);
+    if (argc > 1 && strcmp(argv[1], "sweep") == 0) return Sweep(argv[0], argc - 2, argv + 2);
+    if (argc > 1 && strcmp(argv[1], "regress") == 0) return Regress(argv[0], argc - 2, argv + 2);
+    if (argc > 1 && strcmp(argv[1], "fake-prom") == 0) return FakeProm(argv[0], argc - 2, argv + 2);
+
+    opt.size = PROM_SIZE;
+    opt.fill = 0xff;
+
+    for (int i = 1; i < argc; i ++) {
+        if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            opt.size = strtol(argv[++ i], NULL, 0);
+            opt.runtime = true;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            opt.threads = strtol(argv[++ i], NULL, 0);
+            opt.runtime = true;
+        } else if (strcmp(argv[i], "--microcode") == 0 && i + 1 < argc) {
+            opt.microcode = argv[++ i];
+            opt.runtime = true;
+        } else if (strcmp(argv[i], "--watch") == 0) {
+            opt.watch = true;
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            opt.dir = argv[++ i];
+        } else if (strcmp(argv[i], "--mmap") == 0) {
+            opt.mapped = true;
+            opt.runtime = true;
+        } else if (strcmp(argv[i], "--incremental") == 0) {
+            opt.incremental = true;
+        } else if (strcmp(argv[i], "--plan") == 0) {
+            opt.plan = true;
+        } else if (strcmp(argv[i], "--check") == 0) {
+            opt.check = true;
+        } else if (strcmp(argv[i], "--ihex") == 0) {
+            opt.ihex = true;
+        } else if (strcmp(argv[i], "--srec") == 0) {
+            opt.srec = true;
+        } else if (strcmp(argv[i], "--fill") == 0 && i + 1 < argc) {
+            opt.fill = strtol(argv[++ i], NULL, 0);
+        } else if (strcmp(argv[i], "--package") == 0) {
+            opt.package = true;
+        } else if (strcmp(argv[i], "--store") == 0 && i + 1 < argc) {
+            opt.store = argv[++ i];
+        } else if (strcmp(argv[i], "--variants") == 0 && i + 1 < argc) {
+            opt.variants = argv[++ i];
+        } else if (strcmp(argv[i], "--prune") == 0) {
+            opt.prune = true;
+        } else if (strcmp(argv[i], "--liveness") == 0) {
+            opt.liveness = true;
+        } else if (strcmp(argv[i], "--polarity") == 0) {
+            opt.polarity = true;
+        } else if (strcmp(argv[i], "--auto-polarity") == 0) {
+            opt.autoPolarity = true;
+            opt.runtime = true;
+        } else {
+            Usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (opt.size < PROM_SIZE || opt.size > MAX_PROM_SIZE || (opt.size & (opt.size - 1)) != 0) {
+        fprintf(stderr, "%s: unsupported part size %d\n", argv[0], opt.size);
+        Usage(argv[0]);
+        return EXIT_FAILURE;
     }
 
-    FILE *of1;
-    FILE *of2;
-    FILE *of3;
-    FILE *of4;
-    FILE *of5;
-    FILE *of6;
-    FILE *of7;
-    FILE *of8;
-    FILE *of9;
-    FILE *ofa;
-    FILE *ofb;
-    FILE *ofc;
-
-    // -- Open each output file in turn
-    of1 = fopen("ctrl1.bin", "w");
-    if (!of1) perror("Unable to open ctrl1.bin");
-
-    of2 = fopen("ctrl2.bin", "w");
-    if (!of2) perror("Unable to open ctrl2.bin");
-
-    of3 = fopen("ctrl3.bin", "w");
-    if (!of3) perror("Unable to open ctrl3.bin");
-
-    of4 = fopen("ctrl4.bin", "w");
-    if (!of4) perror("Unable to open ctrl4.bin");
-
-    of5 = fopen("ctrl5.bin", "w");
-    if (!of5) perror("Unable to open ctrl5.bin");
-
-    of6 = fopen("ctrl6.bin", "w");
-    if (!of6) perror("Unable to open ctrl6.bin");
-
-    of7 = fopen("ctrl7.bin", "w");
-    if (!of7) perror("Unable to open ctrl7.bin");
-
-    of8 = fopen("ctrl8.bin", "w");
-    if (!of8) perror("Unable to open ctrl8.bin");
-
-    of9 = fopen("ctrl9.bin", "w");
-    if (!of9) perror("Unable to open ctrl9.bin");
-
-    ofa = fopen("ctrla.bin", "w");
-    if (!ofa) perror("Unable to open ctrla.bin");
-
-    ofb = fopen("ctrlb.bin", "w");
-    if (!ofb) perror("Unable to open ctrlb.bin");
-
-    ofc = fopen("ctrlc.bin", "w");
-    if (!ofc) perror("Unable to open ctrlc.bin");
-
-
-    // -- write each EEPROM
-    for (int i = 0; i < PROM_SIZE; i ++) {
-        uint8_t byte1 = (promBuffer[i] >>  0) & 0xff;
-        uint8_t byte2 = (promBuffer[i] >>  8) & 0xff;
-        uint8_t byte3 = (promBuffer[i] >> 16) & 0xff;
-        uint8_t byte4 = (promBuffer[i] >> 24) & 0xff;
-        uint8_t byte5 = (promBuffer[i] >> 32) & 0xff;
-        uint8_t byte6 = (promBuffer[i] >> 40) & 0xff;
-        uint8_t byte7 = (promBuffer[i] >> 48) & 0xff;
-        uint8_t byte8 = (promBuffer[i] >> 56) & 0xff;
-        uint8_t byte9 = (promBuffer[i] >> 64) & 0xff;
-        uint8_t bytea = (promBuffer[i] >> 72) & 0xff;
-        uint8_t byteb = (promBuffer[i] >> 80) & 0xff;
-        uint8_t bytec = (promBuffer[i] >> 88) & 0xff;
-
-        fwrite(&byte1, 1, sizeof(uint8_t), of1);
-        fwrite(&byte2, 1, sizeof(uint8_t), of2);
-        fwrite(&byte3, 1, sizeof(uint8_t), of3);
-        fwrite(&byte4, 1, sizeof(uint8_t), of4);
-        fwrite(&byte5, 1, sizeof(uint8_t), of5);
-        fwrite(&byte6, 1, sizeof(uint8_t), of6);
-        fwrite(&byte7, 1, sizeof(uint8_t), of7);
-        fwrite(&byte8, 1, sizeof(uint8_t), of8);
-        fwrite(&byte9, 1, sizeof(uint8_t), of9);
-        fwrite(&bytea, 1, sizeof(uint8_t), ofa);
-        fwrite(&byteb, 1, sizeof(uint8_t), ofb);
-        fwrite(&bytec, 1, sizeof(uint8_t), ofc);
+    if (opt.fill < 0 || opt.fill > 0xff) {
+        fprintf(stderr, "%s: the fill byte must be 0..0xff\n", argv[0]);
+        Usage(argv[0]);
+        return EXIT_FAILURE;
     }
 
-    // -- Flush the buffers -- just to be sure
-    fflush(of1);
-    fflush(of2);
-    fflush(of3);
-    fflush(of4);
-    fflush(of5);
-    fflush(of6);
-    fflush(of7);
-    fflush(of8);
-    fflush(of9);
-    fflush(ofa);
-    fflush(ofb);
-    fflush(ofc);
-
-
-    // -- close the files
-    fclose(of1);
-    fclose(of2);
-    fclose(of3);
-    fclose(of4);
-    fclose(of5);
-    fclose(of6);
-    fclose(of7);
-    fclose(of8);
-    fclose(of9);
-    fclose(ofa);
-    fclose(ofb);
-    fclose(ofc);
+    if (opt.watch && !opt.microcode) {
+        fprintf(stderr, "%s: --watch needs --microcode\n", argv[0]);
+        Usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (opt.check && opt.autoPolarity) {
+        fprintf(stderr, "%s: --check compares against the compiled-in polarity; drop --auto-polarity\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (opt.prune && opt.incremental) {
+        fprintf(stderr, "%s: --incremental needs every image from the last run; drop --prune\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (opt.variants && (opt.microcode || opt.size != PROM_SIZE || opt.mapped || opt.autoPolarity || opt.incremental ||
+            opt.check || opt.polarity || opt.liveness || opt.watch)) {
+        fprintf(stderr, "%s: each variant gives its own microcode, size and polarity; --variants only takes\n"
+                "the options for what else to write\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (opt.variants) return GenerateVariants(&opt);
+
+    if (opt.watch) return Watch(&opt);
+
+
+    // -- pick the microcode
+    const OpcodeTable *table = &opcodeTable;
+
+    if (opt.microcode) {
+        if (!LoadMicrocode(opt.microcode, &loaded)) return EXIT_FAILURE;
+        table = &loaded;
+    }
+
+    if (opt.check) return CheckGenerator(table, opt.threads);
+
+
+    // -- pick the polarity; the compiled-in table cannot change, so work on a copy of it
+    if (opt.polarity || opt.autoPolarity) {
+        if (table != &loaded) loaded = *table;
+        table = &loaded;
+
+        if (!ChoosePolarity(&opt, &loaded)) return EXIT_FAILURE;
+        if (opt.polarity && !opt.autoPolarity) return EXIT_SUCCESS;
+    }
+
+    if (opt.liveness) return ReportLiveness(&opt, table) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    return Generate(&opt, table) ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
 
@@ -0,0 +1,520 @@
+//===================================================================================================================
+//  control.h -- The control signals for the 16-Bit Computer From Scratch
+//
+//  These are the control signals as they are wired to the 12 EEPROMs which make up the breadboard control logic.
+//  Each EEPROM drives 8 of the signals (a "lane"); lane 1 is the low byte of the control word.
+//
+//  -----------------------------------------------------------------------------------------------------------------
+//
+//     Date      Tracker  Version  Pgmr  Description
+//  -----------  -------  -------  ----  ---------------------------------------------------------------------------
+//  2026-Oct-16  Initial  v0.0.1   ADCL  Initial version (split from control.cc)
+//  2026-Oct-16  Initial  v0.0.2   ADCL  Add the flags each instruction depends on, FLAG_NONE and FLAG_ALL
+//  2026-Oct-16  Initial  v0.0.3   ADCL  The microcode is written in microcode.txt
+//  2026-Oct-16  Initial  v0.0.4   ADCL  Add EEPROM_PAGE_SIZE
+//  2026-Oct-16  Initial  v0.0.5   ADCL  Add ACTIVE_LOW, and carry it in the decode table
+//
+//===================================================================================================================
+
+
+#pragma once
+
+
+#include <cstdint>
+#include <cstddef>
+
+
+typedef __uint128_t uint128_t;
+
+//
+// -- These are the different flags which will change what an instruction will actually do
+//    ------------------------------------------------------------------------------------
+enum {
+    FLAG_NONE               = 0b000ul,        // No flags matter
+    FLAG_CONDITION          = 0b100ul,        // The contition was not met
+    FLAG_ALL                = 0b111ul,        // All the flags that can be presented to the EEPROM
+};
+
+
+//
+// -- These are the different control signals which can be enabled on the PROM
+//    ------------------------------------------------------------------------
+enum : uint128_t {
+    //
+    // == CTRL1
+    //    =====
+
+    // bits 7:6 -- assert to Address Bus 1
+    ADDR_BUS_1_ASSERT_PC    = (((uint128_t)0b00ul)      << 6) << 0,
+    ADDR_BUS_1_ASSERT_RA    = (((uint128_t)0b01ul)      << 6) << 0,
+    ADDR_BUS_1_ASSERT_INTPC = (((uint128_t)0b10ul)      << 6) << 0,
+    ADDR_BUS_1_ASSERT_INTRA = (((uint128_t)0b11ul)      << 6) << 0,
+
+    // bit 5:0 -- assert to Main Bus
+    MAIN_NONE               = (((uint128_t)0b000000ul)  << 0) << 0,
+    MAIN_R1                 = (((uint128_t)0b000001ul)  << 0) << 0,
+    MAIN_R2                 = (((uint128_t)0b000010ul)  << 0) << 0,
+    MAIN_R3                 = (((uint128_t)0b000011ul)  << 0) << 0,
+    MAIN_R4                 = (((uint128_t)0b000100ul)  << 0) << 0,
+    MAIN_R5                 = (((uint128_t)0b000101ul)  << 0) << 0,
+    MAIN_R6                 = (((uint128_t)0b000110ul)  << 0) << 0,
+    MAIN_R7                 = (((uint128_t)0b000111ul)  << 0) << 0,
+    MAIN_R8                 = (((uint128_t)0b001000ul)  << 0) << 0,
+    MAIN_R9                 = (((uint128_t)0b001001ul)  << 0) << 0,
+    MAIN_R10                = (((uint128_t)0b001010ul)  << 0) << 0,
+    MAIN_R11                = (((uint128_t)0b001011ul)  << 0) << 0,
+    MAIN_R12                = (((uint128_t)0b001100ul)  << 0) << 0,
+    MAIN_SP                 = (((uint128_t)0b001101ul)  << 0) << 0,
+    MAIN_RA                 = (((uint128_t)0b001110ul)  << 0) << 0,
+    MAIN_PC                 = (((uint128_t)0b001111ul)  << 0) << 0,
+    MAIN_ISP                = (((uint128_t)0b010000ul)  << 0) << 0,
+    MAIN_IRA                = (((uint128_t)0b010001ul)  << 0) << 0,
+    MAIN_IPC                = (((uint128_t)0b010010ul)  << 0) << 0,
+    MAIN_FETCH              = (((uint128_t)0b010011ul)  << 0) << 0,
+    MAIN_DEV1               = (((uint128_t)0b010100ul)  << 0) << 0,
+    MAIN_DEV2               = (((uint128_t)0b010101ul)  << 0) << 0,
+    MAIN_DEV3               = (((uint128_t)0b010110ul)  << 0) << 0,
+    MAIN_DEV4               = (((uint128_t)0b010111ul)  << 0) << 0,
+    MAIN_DEV5               = (((uint128_t)0b011000ul)  << 0) << 0,
+    MAIN_DEV6               = (((uint128_t)0b011001ul)  << 0) << 0,
+    MAIN_DEV7               = (((uint128_t)0b011010ul)  << 0) << 0,
+    MAIN_DEV8               = (((uint128_t)0b011011ul)  << 0) << 0,
+    MAIN_DEV9               = (((uint128_t)0b011100ul)  << 0) << 0,
+    MAIN_DEV10              = (((uint128_t)0b011101ul)  << 0) << 0,
+    MAIN_ALU_ADDER          = (((uint128_t)0b011110ul)  << 0) << 0,
+    MAIN_MEMORY             = (((uint128_t)0b011111ul)  << 0) << 0,
+
+    MAIN_CTL1               = (((uint128_t)0b100100ul)  << 0) << 0,
+    MAIN_CTL2               = (((uint128_t)0b100101ul)  << 0) << 0,
+    MAIN_CTL3               = (((uint128_t)0b100110ul)  << 0) << 0,
+    MAIN_CTL4               = (((uint128_t)0b100111ul)  << 0) << 0,
+    MAIN_CTL5               = (((uint128_t)0b101000ul)  << 0) << 0,
+    MAIN_CTL6               = (((uint128_t)0b101001ul)  << 0) << 0,
+    MAIN_CTL7               = (((uint128_t)0b101010ul)  << 0) << 0,
+    MAIN_CTL8               = (((uint128_t)0b101011ul)  << 0) << 0,
+    MAIN_CTL9               = (((uint128_t)0b101100ul)  << 0) << 0,
+    MAIN_CTL10              = (((uint128_t)0b101101ul)  << 0) << 0,
+
+
+    //---------------------------------------------------
+
+    //
+    // == CTRL2
+    //    =====
+
+    // bits 7:6 -- PC Load/Inc/Dec
+    PC_DO_NOTHING           = (((uint128_t)0b00ul)      << 6) << 8,
+    PC_LOAD                 = (((uint128_t)0b01ul)      << 6) << 8,
+    PC_INC                  = (((uint128_t)0b10ul)      << 6) << 8,
+    PC_DEC                  = (((uint128_t)0b11ul)      << 6) << 8,
+
+    // bits 5:4 -- RA Load/Inc/Dec
+    RA_DO_NOTHING           = (((uint128_t)0b00ul)      << 4) << 8,
+    RA_LOAD                 = (((uint128_t)0b01ul)      << 4) << 8,
+    RA_INC                  = (((uint128_t)0b10ul)      << 4) << 8,
+    RA_DEC                  = (((uint128_t)0b11ul)      << 4) << 8,
+
+    // bits 3:2 -- SP Load/Inc/Dec
+    SP_DO_NOTHING           = (((uint128_t)0b00ul)      << 2) << 8,
+    SP_LOAD                 = (((uint128_t)0b01ul)      << 2) << 8,
+    SP_INC                  = (((uint128_t)0b10ul)      << 2) << 8,
+    SP_DEC                  = (((uint128_t)0b11ul)      << 2) << 8,
+
+    // bits 1:0 -- INT-PC Load/Inc/Dec
+    INT_PC_DO_NOTHING       = (((uint128_t)0b00ul)      << 0) << 8,
+    INT_PC_LOAD             = (((uint128_t)0b01ul)      << 0) << 8,
+    INT_PC_INC              = (((uint128_t)0b10ul)      << 0) << 8,
+    INT_PC_DEC              = (((uint128_t)0b11ul)      << 0) << 8,
+
+
+    //---------------------------------------------------
+
+    //
+    // == CTRL3
+    //    =====
+
+    // bits 7:6 -- INT-RA Load/Inc/Dec
+    INT_RA_DO_NOTHING       = (((uint128_t)0b00ul)      << 6) << 16,
+    INT_RA_LOAD             = (((uint128_t)0b01ul)      << 6) << 16,
+    INT_RA_INC              = (((uint128_t)0b10ul)      << 6) << 16,
+    INT_RA_DEC              = (((uint128_t)0b11ul)      << 6) << 16,
+
+    // bits 5:4 -- INT-SP Load/Inc/Dec
+    INT_SP_DO_NOTHING       = (((uint128_t)0b00ul)      << 4) << 16,
+    INT_SP_LOAD             = (((uint128_t)0b01ul)      << 4) << 16,
+    INT_SP_INC              = (((uint128_t)0b10ul)      << 4) << 16,
+    INT_SP_DEC              = (((uint128_t)0b11ul)      << 4) << 16,
+
+    // bit 3 -- Memory Write
+    MEMORY_NOTHING          = (((uint128_t)0b0ul)       << 3) << 16,
+    MEMORY_WRITE            = (((uint128_t)0b1ul)       << 3) << 16,
+
+    // bit 2 -- Fetch Assert to Instruction
+    INSTRUCTION_ASSERT      = (((uint128_t)0b0ul)       << 2) << 16,
+    INSTRUCTION_SUPPRESS    = (((uint128_t)0b1ul)       << 2) << 16,
+
+    // bit 1 -- R1 Load
+    R1_DO_NOTHING           = (((uint128_t)0b0ul)       << 1) << 16,
+    R1_LOAD                 = (((uint128_t)0b1ul)       << 1) << 16,
+
+    // bit 0 -- R2 Load
+    R2_DO_NOTHING           = (((uint128_t)0b0ul)       << 0) << 16,
+    R2_LOAD                 = (((uint128_t)0b1ul)       << 0) << 16,
+
+
+    //---------------------------------------------------
+
+    //
+    // == CTRL4
+    //    =====
+
+    // bit 7 -- R3 Load
+    R3_DO_NOTHING           = (((uint128_t)0b0ul)       << 7) << 24,
+    R3_LOAD                 = (((uint128_t)0b1ul)       << 7) << 24,
+
+    // bit 6 -- R4 Load
+    R4_DO_NOTHING           = (((uint128_t)0b0ul)       << 6) << 24,
+    R4_LOAD                 = (((uint128_t)0b1ul)       << 6) << 24,
+
+    // bit 5 -- R5 Load
+    R5_DO_NOTHING           = (((uint128_t)0b0ul)       << 5) << 24,
+    R5_LOAD                 = (((uint128_t)0b1ul)       << 5) << 24,
+
+    // bit 4 -- R6 Load
+    R6_DO_NOTHING           = (((uint128_t)0b0ul)       << 4) << 24,
+    R6_LOAD                 = (((uint128_t)0b1ul)       << 4) << 24,
+
+    // bit 3 -- R7 Load
+    R7_DO_NOTHING           = (((uint128_t)0b0ul)       << 3) << 24,
+    R7_LOAD                 = (((uint128_t)0b1ul)       << 3) << 24,
+
+    // bit 2 -- R8 Load
+    R8_DO_NOTHING           = (((uint128_t)0b0ul)       << 2) << 24,
+    R8_LOAD                 = (((uint128_t)0b1ul)       << 2) << 24,
+
+    // bit 1 -- R9 Load
+    R9_DO_NOTHING           = (((uint128_t)0b0ul)       << 1) << 24,
+    R9_LOAD                 = (((uint128_t)0b1ul)       << 1) << 24,
+
+    // bit 0 -- R10 Load
+    R10_DO_NOTHING          = (((uint128_t)0b0ul)       << 0) << 24,
+    R10_LOAD                = (((uint128_t)0b1ul)       << 0) << 24,
+
+
+    //---------------------------------------------------
+
+    //
+    // == CTRL5
+    //    =====
+
+    // bit 7 -- R11 Load
+    R11_DO_NOTHING          = (((uint128_t)0b0ul)       << 7) << 32,
+    R11_LOAD                = (((uint128_t)0b1ul)       << 7) << 32,
+
+    // bit 6 -- R12 Load
+    R12_DO_NOTHING          = (((uint128_t)0b0ul)       << 6) << 32,
+    R12_LOAD                = (((uint128_t)0b1ul)       << 6) << 32,
+
+    // bit 5 -- DEV01 Load
+    DEV01_DO_NOTHING        = (((uint128_t)0b0ul)       << 5) << 32,
+    DEV01_LOAD              = (((uint128_t)0b1ul)       << 5) << 32,
+
+    // bit 4 -- CTL01 Load
+    CTL01_DO_NOTHING        = (((uint128_t)0b0ul)       << 4) << 32,
+    CTL01_LOAD              = (((uint128_t)0b1ul)       << 4) << 32,
+
+    // bit 3 -- DEV02 Load
+    DEV02_DO_NOTHING        = (((uint128_t)0b0ul)       << 3) << 32,
+    DEV02_LOAD              = (((uint128_t)0b1ul)       << 3) << 32,
+
+    // bit 2 -- CTL02 Load
+    CTL02_DO_NOTHING        = (((uint128_t)0b0ul)       << 2) << 32,
+    CTL02_LOAD              = (((uint128_t)0b1ul)       << 2) << 32,
+
+    // bit 1 -- DEV03 Load
+    DEV03_DO_NOTHING        = (((uint128_t)0b0ul)       << 1) << 32,
+    DEV03_LOAD              = (((uint128_t)0b1ul)       << 1) << 32,
+
+    // bit 0 -- CTL03 Load
+    CTL03_DO_NOTHING        = (((uint128_t)0b0ul)       << 0) << 32,
+    CTL03_LOAD              = (((uint128_t)0b1ul)       << 0) << 32,
+
+
+    //---------------------------------------------------
+
+    //
+    // == CTRL6
+    //    =====
+
+    // bit 7 -- DEV04 Load
+    DEV04_DO_NOTHING        = (((uint128_t)0b0ul)       << 7) << 40,
+    DEV04_LOAD              = (((uint128_t)0b1ul)       << 7) << 40,
+
+    // bit 6 -- CTL04 Load
+    CTL04_DO_NOTHING        = (((uint128_t)0b0ul)       << 6) << 40,
+    CTL04_LOAD              = (((uint128_t)0b1ul)       << 6) << 40,
+
+    // bit 5 -- DEV05 Load
+    DEV05_DO_NOTHING        = (((uint128_t)0b0ul)       << 5) << 40,
+    DEV05_LOAD              = (((uint128_t)0b1ul)       << 5) << 40,
+
+    // bit 4 -- CTL05 Load
+    CTL05_DO_NOTHING        = (((uint128_t)0b0ul)       << 4) << 40,
+    CTL05_LOAD              = (((uint128_t)0b1ul)       << 4) << 40,
+
+    // bit 3 -- DEV06 Load
+    DEV06_DO_NOTHING        = (((uint128_t)0b0ul)       << 3) << 40,
+    DEV06_LOAD              = (((uint128_t)0b1ul)       << 3) << 40,
+
+    // bit 2 -- CTL06 Load
+    CTL06_DO_NOTHING        = (((uint128_t)0b0ul)       << 2) << 40,
+    CTL06_LOAD              = (((uint128_t)0b1ul)       << 2) << 40,
+
+    // bit 1 -- DEV07 Load
+    DEV07_DO_NOTHING        = (((uint128_t)0b0ul)       << 1) << 40,
+    DEV07_LOAD              = (((uint128_t)0b1ul)       << 1) << 40,
+
+    // bit 0 -- CTL07 Load
+    CTL07_DO_NOTHING        = (((uint128_t)0b0ul)       << 0) << 40,
+    CTL07_LOAD              = (((uint128_t)0b1ul)       << 0) << 40,
+
+
+    //---------------------------------------------------
+
+    //
+    // == CTRL7
+    //    =====
+
+    // bit 7 -- DEV08 Load
+    DEV08_DO_NOTHING        = (((uint128_t)0b0ul)       << 7) << 48,
+    DEV08_LOAD              = (((uint128_t)0b1ul)       << 7) << 48,
+
+    // bit 6 -- CTL08 Load
+    CTL08_DO_NOTHING        = (((uint128_t)0b0ul)       << 6) << 48,
+    CTL08_LOAD              = (((uint128_t)0b1ul)       << 6) << 48,
+
+    // bit 5 -- DEV09 Load
+    DEV09_DO_NOTHING        = (((uint128_t)0b0ul)       << 5) << 48,
+    DEV09_LOAD              = (((uint128_t)0b1ul)       << 5) << 48,
+
+    // bit 4 -- CTL09 Load
+    CTL09_DO_NOTHING        = (((uint128_t)0b0ul)       << 4) << 48,
+    CTL09_LOAD              = (((uint128_t)0b1ul)       << 4) << 48,
+
+    // bit 3 -- DEV10 Load
+    DEV10_DO_NOTHING        = (((uint128_t)0b0ul)       << 3) << 48,
+    DEV10_LOAD              = (((uint128_t)0b1ul)       << 3) << 48,
+
+    // bit 2 -- CTL10 Load
+    CTL10_DO_NOTHING        = (((uint128_t)0b0ul)       << 2) << 48,
+    CTL10_LOAD              = (((uint128_t)0b1ul)       << 2) << 48,
+
+    // bits 1:0 -- Unused for now
+
+
+    //---------------------------------------------------
+
+    //
+    // == CTRL8
+    //    =====
+
+    // bit 7 -- Clear Carry Flag
+    CLC                     = (((uint128_t)0b1ul)       << 7) << 56,
+
+    // bit 6 -- Set Carry Flag
+    STC                     = (((uint128_t)0b1ul)       << 6) << 56,
+
+    // bit 5 -- Latch Z Flag (Pgm)
+    PGM_Z_LATCH             = (((uint128_t)0b1ul)       << 5) << 56,
+
+    // bit 4 -- Latch C Flag (Pgm)
+    PGM_C_LATCH             = (((uint128_t)0b1ul)       << 4) << 56,
+
+    // bit 3 -- Latch N Flag (Pgm)
+    PGM_N_LATCH             = (((uint128_t)0b1ul)       << 3) << 56,
+
+    // bit 2 -- Latch V Flag (Pgm)
+    PGM_V_LATCH             = (((uint128_t)0b1ul)       << 2) << 56,
+
+    // bit 1 -- Latch L Flag (Pgm)
+    PGM_L_LATCH             = (((uint128_t)0b1ul)       << 1) << 56,
+
+    // bit 0 -- ALU Input Latch
+    ALU_INPUT_LATCH         = (((uint128_t)0b1ul)       << 0) << 56,
+
+
+    //---------------------------------------------------
+
+    //
+    // == CTRL9
+    //    =====
+
+    // bit 7:6 -- Carry Select
+    CARRY_0                 = (((uint128_t)0b00ul)      << 6) << 64,
+    CARRY_LAST              = (((uint128_t)0b01ul)      << 6) << 64,
+    CARRY_INVERTED          = (((uint128_t)0b10ul)      << 6) << 64,
+    CARRY_1                 = (((uint128_t)0b11ul)      << 6) << 64,
+
+    // bit 5 -- Latch Z Flag (Pgm)
+    INT_Z_LATCH             = (((uint128_t)0b1ul)       << 5) << 64,
+
+    // bit 4 -- Latch C Flag (Pgm)
+    INT_C_LATCH             = (((uint128_t)0b1ul)       << 4) << 64,
+
+    // bit 3 -- Latch N Flag (Pgm)
+    INT_N_LATCH             = (((uint128_t)0b1ul)       << 3) << 64,
+
+    // bit 2 -- Latch V Flag (Pgm)
+    INT_V_LATCH             = (((uint128_t)0b1ul)       << 2) << 64,
+
+    // bit 1 -- Latch L Flag (Pgm)
+    INT_L_LATCH             = (((uint128_t)0b1ul)       << 1) << 64,
+
+    // bit 0 -- Unused for now
+
+
+    //---------------------------------------------------
+
+
+
+    //
+    // == CTRL10
+    //    ======
+
+    // bit 7:4 -- ALU A Assert
+    ALUA_NONE               = (((uint128_t)0b0000ul)    << 4) << 72,
+    ALUA_R1                 = (((uint128_t)0b0001ul)    << 4) << 72,
+    ALUA_R2                 = (((uint128_t)0b0010ul)    << 4) << 72,
+    ALUA_R3                 = (((uint128_t)0b0011ul)    << 4) << 72,
+    ALUA_R4                 = (((uint128_t)0b0100ul)    << 4) << 72,
+    ALUA_R5                 = (((uint128_t)0b0101ul)    << 4) << 72,
+    ALUA_R6                 = (((uint128_t)0b0110ul)    << 4) << 72,
+    ALUA_R7                 = (((uint128_t)0b0111ul)    << 4) << 72,
+    ALUA_R8                 = (((uint128_t)0b1000ul)    << 4) << 72,
+    ALUA_R9                 = (((uint128_t)0b1001ul)    << 4) << 72,
+    ALUA_R10                = (((uint128_t)0b1010ul)    << 4) << 72,
+    ALUA_R11                = (((uint128_t)0b1011ul)    << 4) << 72,
+    ALUA_R12                = (((uint128_t)0b1100ul)    << 4) << 72,
+    ALUA_PGM_SP             = (((uint128_t)0b1101ul)    << 4) << 72,
+    ALUA_INT_SP             = (((uint128_t)0b1110ul)    << 4) << 72,
+
+    // bit 3:0 -- ALU B Assert
+    ALUB_NONE               = (((uint128_t)0b0000ul)    << 0) << 72,
+    ALUB_R1                 = (((uint128_t)0b0001ul)    << 0) << 72,
+    ALUB_R2                 = (((uint128_t)0b0010ul)    << 0) << 72,
+    ALUB_R3                 = (((uint128_t)0b0011ul)    << 0) << 72,
+    ALUB_R4                 = (((uint128_t)0b0100ul)    << 0) << 72,
+    ALUB_R5                 = (((uint128_t)0b0101ul)    << 0) << 72,
+    ALUB_R6                 = (((uint128_t)0b0110ul)    << 0) << 72,
+    ALUB_R7                 = (((uint128_t)0b0111ul)    << 0) << 72,
+    ALUB_R8                 = (((uint128_t)0b1000ul)    << 0) << 72,
+    ALUB_R9                 = (((uint128_t)0b1001ul)    << 0) << 72,
+    ALUB_R10                = (((uint128_t)0b1010ul)    << 0) << 72,
+    ALUB_R11                = (((uint128_t)0b1011ul)    << 0) << 72,
+    ALUB_R12                = (((uint128_t)0b1100ul)    << 0) << 72,
+    ALUB_FETCH              = (((uint128_t)0b1101ul)    << 0) << 72,
+    ALUB_MEM                = (((uint128_t)0b1110ul)    << 0) << 72,
+
+
+    //---------------------------------------------------
+
+
+    //
+    // == Improve code readability
+    //    ========================
+    FETCH_ASSERT_MAIN       = MAIN_FETCH | INSTRUCTION_SUPPRESS,
+    NOP_SIGNALS             = ADDR_BUS_1_ASSERT_PC | PC_INC,    // `| INSTRUCTION_ASSERT` == `| 0`, ∴ omitted
+    ALU_LATCHES             = PGM_Z_LATCH | PGM_C_LATCH | PGM_N_LATCH | PGM_V_LATCH | PGM_L_LATCH | ALU_INPUT_LATCH,
+};
+
+
+//
+// -- These are the bits which are active low on the board, and so are inverted as they are written to the
+//    EEPROMs.  An erased EEPROM reads 0xff, so the more bytes which come out as 0xff the fewer there are to
+//    program; `eeprom --polarity` will report the best choice for each EEPROM.  Note that inverting one bit of a
+//    multi-bit field (MAIN, ALUA, ...) needs an inverter on that line to the decoder.
+//    -----------------------------------------------------------------------------------------------------------
+const uint128_t ACTIVE_LOW = 0;
+
+
+//
+// -- This #define should help readability in the code
+//    since a '1' on that flag means that the condition was not met
+//    -------------------------------------------------------------
+#define CONDITION_MET(x) (((x) & FLAG_CONDITION) == 0)
+
+
+//
+// -- the size of the eeprom
+//    ----------------------
+const int PROM_SIZE = 1024 * 32;         // we are using 32KB EEPROM
+
+
+//
+// -- the number of instructions which can be encoded (12 bits) and therefore the size of each flags bank
+//    ---------------------------------------------------------------------------------------------------
+const int INSTR_COUNT = 1 << 12;
+
+
+//
+// -- the page-write size of the 28C256; this is the smallest unit we can program
+//    ---------------------------------------------------------------------------
+const int EEPROM_PAGE_SIZE = 64;
+
+
+//
+// -- the number of EEPROMs (8-bit lanes) which make up the control word
+//    ------------------------------------------------------------------
+const int CTRL_LANES = 12;
+
+
+//
+// -- This is the decoded description of a single instruction.  Every instruction in the 12-bit space gets one
+//    of these, whether it is defined or not (undefined instructions behave as a NOP).
+//
+//    When the condition is not met, an instruction does nothing.  If the instruction is followed by an imm16
+//    word in the instruction stream, it still needs to skip that word since it is a constant value and not
+//    an instruction.
+//
+//    Only the flag bits named in `flags` change the control signals for an instruction.  Every other flag bit is
+//    a "don't care", so the control word only needs to be worked out once for each combination of the bits which
+//    do matter, and then copied into each flags bank which shares that combination.
+//    -----------------------------------------------------------------------------------------------------------
+typedef struct OpcodeDesc {
+    uint128_t met;                           // the control signals when the condition is met
+    uint128_t notMet;                        // the control signals when the condition is not met
+    int flags;                               // the flag bits the control signals depend on
+    bool immediate;                          // an imm16 follows the instruction and must be skipped if not met
+} OpcodeDesc;
+
+
+//
+// -- This is the microcode for each instruction, as it is written in microcode.txt
+//    -----------------------------------------------------------------------------
+typedef struct Microcode {
+    int opcode;                              // the instruction from opcodes.h
+    int flags;                               // the flag bits the control signals depend on
+    bool immediate;                          // an imm16 follows the instruction
+    uint128_t met;                           // the control signals when the condition is met
+} Microcode;
+
+
+//
+// -- The dense decode table, indexed by the 12-bit instruction, along with the bits to invert as the control words
+//    are written to the EEPROMs
+//    -------------------------------------------------------------------------------------------------------------
+typedef struct OpcodeTable {
+    OpcodeDesc desc[INSTR_COUNT];
+    uint128_t activeLow;
+} OpcodeTable;
+
+
+//
+// -- Determine the control signals for an instruction given the flags presented with it
+//    ----------------------------------------------------------------------------------
+constexpr uint128_t OpcodeSignals(const OpcodeDesc &desc, int flags)
+{
+    return CONDITION_MET(flags & desc.flags) ? desc.met : desc.notMet;
+}
+
+
@@ -0,0 +1,77 @@
+//===================================================================================================================
+//  crc.cc -- The checksums and hashes: CRC-32 (the zlib / PNG one: reflected, polynomial 0xedb88320) for checking
+//            images, and 64-bit FNV-1a for telling things apart quickly
+//
+//  -----------------------------------------------------------------------------------------------------------------
+//
+//     Date      Tracker  Version  Pgmr  Description
+//  -----------  -------  -------  ----  ---------------------------------------------------------------------------
+//  2026-Oct-16  Initial  v0.0.1   ADCL  Initial version
+//  2026-Oct-16  Initial  v0.0.2   ADCL  Take in FNV-1a from cache.cc
+//
+//===================================================================================================================
+
+
+#include <cstdint>
+#include <cstddef>
+
+#include "eeprom.h"
+
+
+
+//
+// -- The byte-at-a-time table, built by the compiler
+//    -----------------------------------------------
+typedef struct Crc32Table {
+    uint32_t entry[256];
+} Crc32Table;
+
+
+constexpr Crc32Table BuildCrc32Table(void)
+{
+    Crc32Table table = {};
+
+    for (uint32_t i = 0; i < 256; i ++) {
+        uint32_t crc = i;
+
+        for (int b = 0; b < 8; b ++) crc = (crc & 1) ? (crc >> 1) ^ 0xedb88320 : crc >> 1;
+
+        table.entry[i] = crc;
+    }
+
+    return table;
+}
+
+
+inline constexpr Crc32Table crc32Table = BuildCrc32Table();
+
+
+
+//
+// -- Carry a CRC-32 on over more data; start with 0
+//    ----------------------------------------------
+uint32_t Crc32(uint32_t crc, const uint8_t *data, size_t len)
+{
+    crc = ~crc;
+
+    for (size_t i = 0; i < len; i ++) crc = crc32Table.entry[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+
+    return ~crc;
+}
+
+
+
+//
+// -- FNV-1a, 64 bits; carry `hash` on from FNV_OFFSET
+//    ------------------------------------------------
+uint64_t Fnv1a(uint64_t hash, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+
+    for (size_t i = 0; i < len; i ++) {
+        hash ^= p[i];
+        hash *= 0x100000001b3ull;
+    }
+
+    return hash;
+}
@@ -0,0 +1,313 @@
+//===================================================================================================================
+//  eeprom.h -- The pieces of the `eeprom` tool which are shared between its source files
+//
+//  -----------------------------------------------------------------------------------------------------------------
+//
+//     Date      Tracker  Version  Pgmr  Description
+//  -----------  -------  -------  ----  ---------------------------------------------------------------------------
+//  2026-Oct-16  Initial  v0.0.1   ADCL  Initial version
+//  2026-Oct-16  Initial  v0.0.2   ADCL  Add GenerateScalar() so `--check` can run the scalar transpose
+//  2026-Oct-16  Initial  v0.0.3   ADCL  Add laneFile, WriteFileAtomic() and WriteImages()
+//  2026-Oct-16  Initial  v0.0.4   ADCL  Add LanePath() and MapImages(), and write the images into a directory
+//  2026-Oct-16  Initial  v0.0.5   ADCL  Add GenerateIncremental()
+//  2026-Oct-16  Initial  v0.0.6   ADCL  Generate from a decode table; add the names and LoadMicrocode()
+//  2026-Oct-16  Initial  v0.0.7   ADCL  Add WritePlans() and PlanAgainstFiles()
+//  2026-Oct-16  Initial  v0.0.8   ADCL  Add BestPolarity(), WritePolarity() and ReadPolarity()
+//  2026-Oct-16  Initial  v0.0.9   ADCL  Add WriteRecords()
+//  2026-Oct-16  Initial  v0.0.10  ADCL  Add the serial port and XMODEM calls, Upload() and FakeProm()
+//  2026-Oct-16  Initial  v0.0.11  ADCL  Share the TommyPROM prompt calls; add Crc32() and Verify()
+//  2026-Oct-16  Initial  v0.0.12  ADCL  Add EEPROM_VERSION, WritePackage() and Inspect()
+//  2026-Oct-16  Initial  v0.0.13  ADCL  Add ReadImage(), Fnv1a(), StoreImages() and History()
+//  2026-Oct-16  Initial  v0.0.14  ADCL  Add LiveLanes() and PruneImages()
+//  2026-Oct-16  Initial  v0.0.15  ADCL  Add Pack()
+//  2026-Oct-16  Initial  v0.0.16  ADCL  Add ImageWrite and WriteBatch()
+//  2026-Oct-16  Initial  v0.0.17  ADCL  Add Simulate()
+//  2026-Oct-16  Initial  v0.0.18  ADCL  EEPROM_VERSION v0.0.30
+//  2026-Oct-16  Initial  v0.0.19  ADCL  EEPROM_VERSION v0.0.31
+//  2026-Oct-16  Initial  v0.0.20  ADCL  EEPROM_VERSION v0.0.32
+//  2026-Oct-16  Initial  v0.0.21  ADCL  EEPROM_VERSION v0.0.33
+//
+//===================================================================================================================
+
+
+#pragma once
+
+
+#include "control.h"
+
+
+//
+// -- The version of the `eeprom` tool, as recorded in the packages it writes
+//    -----------------------------------------------------------------------
+#define EEPROM_VERSION      "v0.0.33"
+
+
+//
+// -- the largest part we know how to generate an image for (a 4Mbit 29F040 / 39SF040)
+//    --------------------------------------------------------------------------------
+const int MAX_PROM_SIZE = 1024 * 512;
+
+
+//
+// -- the most threads we will use to generate an image
+//    -------------------------------------------------
+const int MAX_THREADS = 64;
+
+
+//
+// -- Generate the image for a part of `size` bytes at runtime from the decode table into the lanes, spreading the
+//    work across `threads` threads (0 means one per online cpu)
+//    ------------------------------------------------------------------------------------------------------------
+void GenerateParallel(const OpcodeTable *table, uint8_t *const lanes[CTRL_LANES], int size, int threads);
+
+
+//
+// -- Generate the same image on one thread with the plain scalar transpose, for `--check` to compare against
+//    -------------------------------------------------------------------------------------------------------
+void GenerateScalar(const OpcodeTable *table, uint8_t *const lanes[CTRL_LANES], int size);
+
+
+//
+// -- The names of the output files, one for each EEPROM
+//    --------------------------------------------------
+extern const char *laneFile[CTRL_LANES];
+
+
+//
+// -- Write `size` bytes to the file `name`.  The data goes to a temporary file which is renamed over `name` once
+//    it is complete, so nobody ever sees a partial image.  Any failure is reported and returns false.
+//    -----------------------------------------------------------------------------------------------------------
+bool WriteFileAtomic(const char *name, const uint8_t *data, size_t size);
+
+
+//
+// -- Build the path to the image for a lane in directory `dir` (NULL or "" for the current directory)
+//    ------------------------------------------------------------------------------------------------
+void LanePath(char *path, size_t len, const char *dir, int lane);
+
+
+//
+// -- Build the path to another file for a lane, such as `ctrl3.plan` for an `ext` of ".plan"
+//    ---------------------------------------------------------------------------------------
+void LaneSidePath(char *path, size_t len, const char *dir, int lane, const char *ext);
+
+
+//
+// -- Write each EEPROM image to its file in `dir`; returns false if any of them could not be written
+//    -----------------------------------------------------------------------------------------------
+bool WriteImages(const char *dir, const uint8_t *const lanes[CTRL_LANES], int size);
+
+
+//
+// -- Write a batch of files, each through a temporary which is renamed into place once they are all written; all
+//    the writes are submitted at once through io_uring, or with pwrite() where that is not available (batch.cc).
+//    Failures are reported, and leave none of the temporaries behind.
+//    -----------------------------------------------------------------------------------------------------------
+typedef struct ImageWrite {
+    const char *path;
+    const uint8_t *data;
+    size_t size;
+} ImageWrite;
+
+bool WriteBatch(const ImageWrite *writes, int count);
+
+
+//
+// -- Read the image for a lane from `dir`; it must be exactly `size` bytes.  Failures are reported.
+//    ----------------------------------------------------------------------------------------------
+bool ReadImage(const char *dir, int lane, uint8_t *data, int size);
+
+
+//
+// -- The images for one set of EEPROMs, mapped straight from their (temporary) files
+//    -------------------------------------------------------------------------------
+typedef struct MappedImages {
+    const char *dir;
+    int size;
+    int fd[CTRL_LANES];
+    uint8_t *lanes[CTRL_LANES];
+} MappedImages;
+
+
+//
+// -- Create each image file in `dir` at `size` bytes and map it so it can be generated in place.  Once the lanes
+//    are filled, CommitImages() puts the files in place; AbandonImages() throws them away.  Failures are
+//    reported and return false, leaving nothing behind.
+//    -----------------------------------------------------------------------------------------------------------
+bool MapImages(MappedImages *map, const char *dir, int size);
+bool CommitImages(MappedImages *map);
+void AbandonImages(MappedImages *map);
+
+
+//
+// -- Bring the images in `dir` up to date for a part of `size` bytes, regenerating only the instructions whose
+//    microcode changed since the last run (everything if there is no usable record of the last run).  With
+//    `plan`, also write the pages which changed for each EEPROM.
+//    ---------------------------------------------------------------------------------------------------------
+bool GenerateIncremental(const OpcodeTable *table, const char *dir, int size, int threads, bool plan);
+
+
+//
+// -- The names of the signals, flags and instructions (signals.cc)
+//    -------------------------------------------------------------
+typedef struct SignalName {
+    const char *name;
+    uint128_t value;
+} SignalName;
+
+
+typedef struct FlagName {
+    const char *name;
+    int flag;
+} FlagName;
+
+
+typedef struct OpcodeName {
+    const char *name;
+    int opcode;
+} OpcodeName;
+
+
+extern const SignalName signalNames[];
+extern const int SIGNAL_NAME_COUNT;
+extern const FlagName flagNames[];
+extern const int FLAG_NAME_COUNT;
+extern const OpcodeName opcodeNames[];
+extern const int OPCODE_NAME_COUNT;
+
+const SignalName *FindSignal(const char *name, size_t len);
+int FindOpcode(const char *name);
+const char *NameOfOpcode(int opcode);
+
+
+//
+// -- Load the microcode from a text description into a decode table (microcode-file.cc).  Problems are reported
+//    against the file and line, and return false.
+//    ----------------------------------------------------------------------------------------------------------
+bool LoadMicrocode(const char *path, OpcodeTable *table);
+
+
+//
+// -- Write `ctrlN.plan` for each EEPROM in `dir`, listing the 64-byte pages which differ between the old and new
+//    images (plan.cc).  Without old images (NULL), or when they are taken from the files already on disk and those
+//    are missing, every page is listed.
+//    -------------------------------------------------------------------------------------------------------------
+bool WritePlans(const char *dir, const uint8_t *const oldLanes[CTRL_LANES], const uint8_t *const newLanes[CTRL_LANES],
+        int size);
+bool PlanAgainstFiles(const char *dir, const uint8_t *const newLanes[CTRL_LANES], int size);
+
+
+//
+// -- Work out the active-low bits which make the most bytes in the images 0xff, given the images were generated
+//    with `activeLow`; with `report`, print how each EEPROM fares now and with the best choice (polarity.cc)
+//    ----------------------------------------------------------------------------------------------------------
+uint128_t BestPolarity(const uint8_t *const lanes[CTRL_LANES], int size, uint128_t activeLow, bool report);
+
+
+//
+// -- The active-low mask a set of images was generated with is kept in `ctrl.polarity` beside them, since the
+//    images cannot be decoded without it (polarity.cc).  ReadPolarity() reports a missing or damaged file.
+//    --------------------------------------------------------------------------------------------------------
+#define POLARITY_FILE       "ctrl.polarity"
+
+bool WritePolarity(const char *dir, uint128_t activeLow);
+bool ReadPolarity(const char *dir, uint128_t *activeLow);
+
+
+//
+// -- Find the EEPROMs which carry something: a bit set for each lane where some bit changes; with `report`, print
+//    which bits never change and how often the others toggle.  PruneImages() removes the images in `dir` (and
+//    their text images and plans) of the lanes which carry nothing (liveness.cc).
+//    ------------------------------------------------------------------------------------------------------------
+uint32_t LiveLanes(const uint8_t *const lanes[CTRL_LANES], int size, bool report);
+bool PruneImages(const char *dir, int size);
+
+
+//
+// -- The text formats the images can also be written in (records.cc)
+//    ---------------------------------------------------------------
+typedef enum {
+    RECORDS_IHEX,                            // Intel HEX, as `ctrlN.hex`
+    RECORDS_SREC,                            // Motorola S-records, as `ctrlN.srec`
+} RecordFormat;
+
+
+//
+// -- Write each image already in `dir` in a text format, leaving out the runs of `fill` bytes (which a programmer
+//    that takes sparse records leaves alone).  Returns false, having reported it, on any failure.
+//    ------------------------------------------------------------------------------------------------------------
+bool WriteRecords(const char *dir, int size, RecordFormat format, uint8_t fill);
+
+
+//
+// -- Talk to a programmer over a serial port (serial.cc).  OpenSerial() sets the port (or pty) up as a raw 115200
+//    baud line and reports any failure; ReadByte() waits up to `ms` (-1 forever) and returns -1 if nothing came.
+//    The XMODEM-CRC calls report their own failures.  XmodemReceive() hands each block to `block` as it arrives
+//    (which can stop the transfer by returning false) and returns the bytes received, or -1.
+//    ------------------------------------------------------------------------------------------------------------
+const int XMODEM_BLOCK = 128;
+
+int OpenSerial(const char *tty);
+int ReadByte(int fd, int ms);
+bool SendBytes(int fd, const void *data, size_t len);
+uint16_t Crc16(const uint8_t *data, size_t len);
+bool XmodemSend(int fd, const uint8_t *data, size_t len);
+long XmodemReceive(int fd, bool (*block)(void *ctx, const uint8_t *data, int len), void *ctx);
+
+
+//
+// -- Talking to TommyPROM (upload.cc): wait for its prompt (after a reset, when the port is first opened), send it
+//    a command, and ask the user to put the EEPROM for a lane in the programmer (false to skip it; `quit` is set
+//    if the user wants to stop altogether)
+//    -------------------------------------------------------------------------------------------------------------
+const int PROMPT_MS = 10 * 1000;
+
+bool WaitPrompt(int fd, int ms);
+bool WaitReady(int fd, const char *tty);
+bool PromptCommand(int fd, const char *cmd);
+bool AskForChip(int lane, bool *quit);
+
+
+//
+// -- CRC-32, as zlib computes it, and 64-bit FNV-1a; carry each on over any number of calls, starting from 0 and
+//    FNV_OFFSET respectively (crc.cc)
+//    -----------------------------------------------------------------------------------------------------------
+const uint64_t FNV_OFFSET = 0xcbf29ce484222325ull;
+
+uint32_t Crc32(uint32_t crc, const uint8_t *data, size_t len);
+uint64_t Fnv1a(uint64_t hash, const void *data, size_t len);
+
+
+//
+// -- Write the package (rom-package.h) into `dir` from the images already there, recording where the microcode
+//    came from as `source` and the active-low mask they were made with.  Failures are reported and return false
+//    (package.cc).
+//    ----------------------------------------------------------------------------------------------------------
+bool WritePackage(const char *dir, int size, const char *source, uint128_t activeLow);
+
+
+//
+// -- Add the images in `dir` to the store of every build in `store`, recording where the microcode came from as
+//    `source` and their active-low mask (store.cc).  Failures are reported and return false.
+//    ----------------------------------------------------------------------------------------------------------
+#define STORE_DIR           "ctrl.store"
+
+bool StoreImages(const char *store, const char *dir, int size, const char *source, uint128_t activeLow);
+
+
+//
+// -- The subcommands: `upload` the images to TommyPROM (upload.cc), and `fake-prom`, a stand-in for TommyPROM on
+//    a pty (fake-prom.cc), `verify` what was read back from the EEPROMs (verify.cc), `inspect` a package
+//    (package.cc), look through the `history` of builds in a store (store.cc), `pack` the fields of the control
+//    word into the fewest EEPROMs (pack.cc), `simulate` a program on the images (sim.cc), `sweep` a program
+//    over its inputs (lockstep.cc) and `regress` a corpus of programs (regress.cc)
+//    -----------------------------------------------------------------------------------------------------------
+int Upload(const char *pgm, int argc, char *argv[]);
+int FakeProm(const char *pgm, int argc, char *argv[]);
+int Verify(const char *pgm, int argc, char *argv[]);
+int Inspect(const char *pgm, int argc, char *argv[]);
+int History(const char *pgm, int argc, char *argv[]);
+int Pack(const char *pgm, int argc, char *argv[]);
+int Simulate(const char *pgm, int argc, char *argv[]);
+int Sweep(const char *pgm, int argc, char *argv[]);
+int Regress(const char *pgm, int argc, char *argv[]);
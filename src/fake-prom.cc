@@ -0,0 +1,221 @@
+//===================================================================================================================
+//  fake-prom.cc -- A stand-in for TommyPROM on a pty, so `eeprom upload` and `verify` can run with no hardware
+//
+//  This opens a pseudo-terminal, prints the name of its slave side (and, with `--link`, makes a symlink to it so
+//  scripts have a fixed name to use) and then behaves like TommyPROM with one blank part in it: it prints a `>`
+//  prompt, echoes what is typed and understands:
+//
+//      Wssss           write the part from address ssss with the data sent with XMODEM-CRC
+//      Rssss eeee      read the part from address ssss to eeee (inclusive) and send it with XMODEM-CRC
+//
+//  Anything else gets an error and the prompt again.  The part starts out erased, or with the contents of the
+//  file given with `--load <file>`.  With `--save <file>`, the part is written to <file> after every write, so
+//  the result of an upload can be compared with the image.
+//
+//  -----------------------------------------------------------------------------------------------------------------
+//
+//     Date      Tracker  Version  Pgmr  Description
+//  -----------  -------  -------  ----  ---------------------------------------------------------------------------
+//  2026-Oct-16  Initial  v0.0.1   ADCL  Initial version
+//  2026-Oct-16  Initial  v0.0.2   ADCL  Add the `R` command and `--load`
+//
+//===================================================================================================================
+
+
+#include <cstdint>
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "eeprom.h"
+
+
+
+//
+// -- The part in the programmer
+//    --------------------------
+typedef struct FakePart {
+    uint8_t *mem;
+    int size;
+    long addr;                               // where the next XMODEM block goes
+} FakePart;
+
+
+
+//
+// -- Say something to whoever is on the other end
+//    --------------------------------------------
+static void Say(int fd, const char *text)
+{
+    SendBytes(fd, text, strlen(text));
+}
+
+
+
+//
+// -- Put one received block into the part; refuse anything past the end
+//    ------------------------------------------------------------------
+static bool StoreBlock(void *ctx, const uint8_t *data, int len)
+{
+    FakePart *part = (FakePart *)ctx;
+
+    if (part->addr + len > part->size) return false;
+
+    memcpy(part->mem + part->addr, data, len);
+    part->addr += len;
+
+    return true;
+}
+
+
+
+//
+// -- Carry out one command line
+//    --------------------------
+static void Execute(int fd, FakePart *part, const char *line, const char *save)
+{
+    char text[128];
+    char *end;
+
+    if (!*line) return;
+
+    long start = strtol(line + 1, &end, 16);
+
+    if ((line[0] == 'W' || line[0] == 'w') && end != line + 1 && !*end && start >= 0 && start < part->size) {
+        Say(fd, "Send the image with XMODEM\r\n");
+
+        part->addr = start;
+        long got = XmodemReceive(fd, StoreBlock, part);
+
+        if (got < 0) {
+            Say(fd, "\r\nTransfer failed\r\n");
+            return;
+        }
+
+        snprintf(text, sizeof(text), "\r\nImported %ld bytes at %04lx\r\n", got, start);
+        Say(fd, text);
+
+        if (save && !WriteFileAtomic(save, part->mem, part->size)) Say(fd, "Unable to save the part\r\n");
+
+        return;
+    }
+
+    long last = *end == ' ' ? strtol(end + 1, &end, 16) : -1;
+
+    if ((line[0] == 'R' || line[0] == 'r') && !*end && start >= 0 && start <= last && last < part->size) {
+        // -- round up to whole blocks, as TommyPROM does
+        long len = (last - start + XMODEM_BLOCK) / XMODEM_BLOCK * XMODEM_BLOCK;
+        if (start + len > part->size) len = part->size - start;
+
+        if (!XmodemSend(fd, part->mem + start, len)) Say(fd, "\r\nTransfer failed\r\n");
+
+        return;
+    }
+
+    Say(fd, "Unknown or malformed command\r\n");
+}
+
+
+
+//
+// -- The `fake-prom` subcommand; this runs until it is killed
+//    --------------------------------------------------------
+int FakeProm(const char *pgm, int argc, char *argv[])
+{
+    static uint8_t mem[MAX_PROM_SIZE];
+    const char *save = NULL;
+    const char *load = NULL;
+    const char *link = NULL;
+    char line[64];
+    int len = 0;
+    FakePart part = { mem, PROM_SIZE, 0 };
+
+    for (int i = 0; i < argc; i ++) {
+        if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) part.size = strtol(argv[++ i], NULL, 0);
+        else if (strcmp(argv[i], "--save") == 0 && i + 1 < argc) save = argv[++ i];
+        else if (strcmp(argv[i], "--load") == 0 && i + 1 < argc) load = argv[++ i];
+        else if (strcmp(argv[i], "--link") == 0 && i + 1 < argc) link = argv[++ i];
+        else {
+            fprintf(stderr, "Usage: %s fake-prom [--size <bytes>] [--load <file>] [--save <file>] [--link <path>]\n",
+                    pgm);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (part.size < PROM_SIZE || part.size > MAX_PROM_SIZE || (part.size & (part.size - 1)) != 0) {
+        fprintf(stderr, "%s: unsupported part size %d\n", pgm, part.size);
+        return EXIT_FAILURE;
+    }
+
+    memset(mem, 0xff, part.size);
+
+    if (load) {
+        FILE *fp = fopen(load, "rb");
+
+        if (!fp) {
+            fprintf(stderr, "Unable to open %s: %s\n", load, strerror(errno));
+            return EXIT_FAILURE;
+        }
+
+        size_t got = fread(mem, 1, part.size, fp);
+        fclose(fp);
+
+        printf("Loaded %zu byte(s) from %s\n", got, load);
+    }
+
+
+    // -- set up the pty; we hold the slave side open too, so it stays raw and we never see a hangup between users
+    int fd = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if (fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0) {
+        fprintf(stderr, "Unable to create a pty: %s\n", strerror(errno));
+        return EXIT_FAILURE;
+    }
+
+    const char *slave = ptsname(fd);
+    int hold = OpenSerial(slave);
+
+    if (hold < 0) return EXIT_FAILURE;
+
+    if (link) {
+        unlink(link);
+
+        if (symlink(slave, link) != 0) {
+            fprintf(stderr, "Unable to link %s to %s: %s\n", link, slave, strerror(errno));
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("TommyPROM stand-in on %s\n", slave);
+    fflush(stdout);
+
+    Say(fd, "\r\nTommyPROM stand-in\r\n>");
+
+    while (true) {
+        int c = ReadByte(fd, -1);
+
+        if (c < 0) {
+            fprintf(stderr, "Lost the pty: %s\n", strerror(errno));
+            return EXIT_FAILURE;
+        }
+
+        if (c == '\r' || c == '\n') {
+            Say(fd, "\r\n");
+
+            line[len] = '\0';
+            Execute(fd, &part, line, save);
+            len = 0;
+
+            Say(fd, "\r\n>");
+        } else if (len < (int)sizeof(line) - 1) {
+            uint8_t echo = c;
+
+            SendBytes(fd, &echo, 1);
+            line[len ++] = c;
+        }
+    }
+}
@@ -0,0 +1,206 @@
+//===================================================================================================================
+//  generate.cc -- Generate an EEPROM image at runtime, using all the cpus we have
+//
+//  The compiled-in image only covers the 32KB part.  When we need another part size, the image is expanded here
+//  instead.  The 4096 instructions are cut into shards and a small pool of threads claims the shards one at a
+//  time.  A shard owns the same slice of instructions in every flags bank, so no two threads ever write the same
+//  byte and each control word is still only worked out once per flags combination.
+//
+//  Within a shard, the instructions are expanded 16 at a time: the 16 control words for a flags bank are
+//  byte-transposed into 16 bytes for each of the 12 EEPROM lanes in one pass.
+//
+//  -----------------------------------------------------------------------------------------------------------------
+//
+//     Date      Tracker  Version  Pgmr  Description
+//  -----------  -------  -------  ----  ---------------------------------------------------------------------------
+//  2026-Oct-16  Initial  v0.0.1   ADCL  Initial version
+//  2026-Oct-16  Initial  v0.0.2   ADCL  Add an SSE2 byte-transpose kernel to split the control words into lanes
+//  2026-Oct-16  Initial  v0.0.3   ADCL  Generate from any decode table, not just the compiled-in one
+//  2026-Oct-16  Initial  v0.0.4   ADCL  Invert the active-low bits
+//
+//===================================================================================================================
+
+
+#include <cstdint>
+#include <stdio.h>
+#include <cstring>
+#include <unistd.h>
+#include <pthread.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "eeprom.h"
+#include "microcode.h"
+
+
+
+//
+// -- the number of instructions in each shard of work
+//    ------------------------------------------------
+const int SHARD_INSTR = 64;
+const int SHARD_COUNT = INSTR_COUNT / SHARD_INSTR;
+
+
+//
+// -- the number of instructions transposed into the lanes at once
+//    ------------------------------------------------------------
+const int BLOCK_INSTR = 16;
+
+
+//
+// -- This is the work shared by all the threads
+//    ------------------------------------------
+typedef struct GenerateJob {
+    const OpcodeTable *table;
+    uint8_t *const *lanes;
+    int size;
+    bool scalar;                             // use the plain scalar transpose, even where there is SSE2
+    int nextShard;                           // the next shard to be claimed; only touched atomically
+} GenerateJob;
+
+
+
+//
+// -- Transpose 16 control words into 16 bytes of each EEPROM lane, starting at `loc`, one byte at a time.  This
+//    is always built, so GenerateScalar() can check the SSE2 kernel against it.
+//    ----------------------------------------------------------------------------------------------------------
+static inline void TransposeScalar(const uint128_t words[BLOCK_INSTR], uint8_t *const lanes[CTRL_LANES], int loc)
+{
+    for (int i = 0; i < BLOCK_INSTR; i ++) {
+        for (int l = 0; l < CTRL_LANES; l ++) lanes[l][loc + i] = (words[i] >> (l * 8)) & 0xff;
+    }
+}
+
+
+//
+// -- The same with SSE2.  Treating the words as a 16x16 matrix of bytes, interleaving row i with row i+8 four
+//    times over leaves column j in row j.
+//    --------------------------------------------------------------------------------------------------------
+#if defined(__SSE2__)
+static inline void TransposeBlock(const uint128_t words[BLOCK_INSTR], uint8_t *const lanes[CTRL_LANES], int loc)
+{
+    __m128i row[16];
+    __m128i tmp[16];
+
+    for (int i = 0; i < 16; i ++) row[i] = _mm_loadu_si128((const __m128i *)&words[i]);
+
+    for (int round = 0; round < 4; round ++) {
+        for (int i = 0; i < 8; i ++) {
+            tmp[i * 2 + 0] = _mm_unpacklo_epi8(row[i], row[i + 8]);
+            tmp[i * 2 + 1] = _mm_unpackhi_epi8(row[i], row[i + 8]);
+        }
+
+        for (int i = 0; i < 16; i ++) row[i] = tmp[i];
+    }
+
+    for (int l = 0; l < CTRL_LANES; l ++) _mm_storeu_si128((__m128i *)&lanes[l][loc], row[l]);
+}
+#else
+static inline void TransposeBlock(const uint128_t words[BLOCK_INSTR], uint8_t *const lanes[CTRL_LANES], int loc)
+{
+    TransposeScalar(words, lanes, loc);
+}
+#endif
+
+
+
+//
+// -- Expand 16 instructions starting at `first`.  This is ExpandInstructions() for a whole block at once: the
+//    block is worked out once for each combination of the flags any of its instructions depend on, and then
+//    copied into each bank which shares that combination.
+//    --------------------------------------------------------------------------------------------------------
+static void ExpandBlock(const OpcodeTable *table, uint8_t *const lanes[CTRL_LANES], int size, int first,
+        bool scalar)
+{
+    int flags = 0;
+    int cls = 0;
+
+    for (int i = 0; i < BLOCK_INSTR; i ++) flags |= table->desc[first + i].flags;
+
+    do {
+        uint128_t words[BLOCK_INSTR];
+        int src = cls * INSTR_COUNT + first;             // bank `cls` is the first bank with this combination
+
+        for (int i = 0; i < BLOCK_INSTR; i ++) words[i] = OpcodeSignals(table->desc[first + i], cls) ^ table->activeLow;
+
+        if (scalar) TransposeScalar(words, lanes, src);
+        else TransposeBlock(words, lanes, src);
+
+        for (int bank = cls + 1; bank < size / INSTR_COUNT; bank ++) {
+            if ((bank & flags) != cls) continue;
+
+            int dst = bank * INSTR_COUNT + first;
+
+            for (int l = 0; l < CTRL_LANES; l ++) memcpy(&lanes[l][dst], &lanes[l][src], BLOCK_INSTR);
+        }
+
+        cls = (cls - flags) & flags;
+    } while (cls != 0);
+}
+
+
+
+//
+// -- Claim shards until there are none left
+//    --------------------------------------
+static void *GenerateWorker(void *arg)
+{
+    GenerateJob *job = (GenerateJob *)arg;
+
+    while (true) {
+        int shard = __atomic_fetch_add(&job->nextShard, 1, __ATOMIC_RELAXED);
+        if (shard >= SHARD_COUNT) break;
+
+        for (int i = shard * SHARD_INSTR; i < (shard + 1) * SHARD_INSTR; i += BLOCK_INSTR) {
+            ExpandBlock(job->table, job->lanes, job->size, i, job->scalar);
+        }
+    }
+
+    return NULL;
+}
+
+
+
+//
+// -- Generate the image for a part of `size` bytes from the decode table into the lanes
+//    ----------------------------------------------------------------------------------
+void GenerateParallel(const OpcodeTable *table, uint8_t *const lanes[CTRL_LANES], int size, int threads)
+{
+    GenerateJob job = { table, lanes, size, false, 0 };
+    pthread_t tid[MAX_THREADS];
+    int started = 0;
+
+    if (threads <= 0) threads = sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads <= 0) threads = 1;
+    if (threads > MAX_THREADS) threads = MAX_THREADS;
+    if (threads > SHARD_COUNT) threads = SHARD_COUNT;
+
+    // -- this thread is one of the workers, so start one less
+    for (int i = 0; i < threads - 1; i ++) {
+        if (pthread_create(&tid[started], NULL, GenerateWorker, &job) != 0) {
+            perror("Unable to start a generator thread");
+            break;
+        }
+
+        started ++;
+    }
+
+    GenerateWorker(&job);
+
+    for (int i = 0; i < started; i ++) pthread_join(tid[i], NULL);
+}
+
+
+
+//
+// -- Generate the same image on this thread with the plain scalar transpose, so the fast one can be checked
+//    against it
+//    ------------------------------------------------------------------------------------------------------
+void GenerateScalar(const OpcodeTable *table, uint8_t *const lanes[CTRL_LANES], int size)
+{
+    GenerateJob job = { table, lanes, size, true, 0 };
+
+    GenerateWorker(&job);
+}
@@ -0,0 +1,469 @@
+//===================================================================================================================
+//  jit.cc -- Translate straight-line runs of the simulated program to x86-64
+//
+//  A block starts from the state the machine is in (PC, the instruction register and whether its condition is
+//  met) and runs for as long as everything about the next cycle can be known when it is translated: the address
+//  bus is PC, so the word fetched is known; PC only counts, so the next PC is known; and the next instruction is
+//  unconditional, so its MicroOp is known.  Each cycle is translated from its MicroOp (predecode.cc) into code
+//  which works on the Cpu in memory; the adder is a 16-bit `adc`, whose flags are the CPU's.  A block ends after
+//  a jump (PC is loaded), before a cycle which addresses memory through anything but PC, before a conditional
+//  instruction, or after a write to memory.
+//
+//  The words a block was translated from are marked by their 256-word page.  A write to memory which lands in
+//  a marked page (from a block, or from a cycle which is interpreted) throws every block away, so code which
+//  writes over itself is translated again from what it wrote.  Anything which cannot be translated runs one cycle
+//  at a time through RunPredecoded().
+//
+//  The code is never writable and executable at once: it is made writable to translate a block and executable
+//  again before it runs.
+//
+//  -----------------------------------------------------------------------------------------------------------------
+//
+//     Date      Tracker  Version  Pgmr  Description
+//  -----------  -------  -------  ----  ---------------------------------------------------------------------------
+//  2026-Oct-16  Initial  v0.0.1   ADCL  Initial version
+//  2026-Oct-16  Initial  v0.0.2   ADCL  Add `ResetJit()`, so one JIT can run many programs
+//
+//===================================================================================================================
+
+
+#include <cstdint>
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <sys/mman.h>
+
+#include "sim.h"
+#include "microcode.h"
+
+
+
+#if defined(__x86_64__)
+
+//
+// -- The sizes of things
+//    -------------------
+const size_t JIT_CODE_SIZE = 4 * 1024 * 1024;       // the code for every block
+const int JIT_SLOTS = 8192;                          // the blocks, found by open addressing
+const int JIT_MAX_BLOCKS = JIT_SLOTS / 2;
+const int JIT_MAX_CYCLES = 64;                       // the longest block
+const size_t JIT_MAX_BLOCK_CODE = JIT_MAX_CYCLES * 512;
+const int JIT_PAGE_SHIFT = 8;                        // the granule for throwing code away: 256 words
+const uint64_t JIT_EMPTY = ~(uint64_t)0;
+
+
+//
+// -- The registers the code uses: rdi holds the Cpu and rsi the memory, and eax, ecx, edx and r8..r10 are
+//    scratch, so no register needs to be saved
+//    ----------------------------------------------------------------------------------------------------
+enum { EAX = 0, ECX = 1, EDX = 2 };
+
+
+//
+// -- A translated block; `cycles` is 0 for a state which cannot be translated
+//    ------------------------------------------------------------------------
+typedef void (*BlockCode)(Cpu *cpu, uint16_t *mem);
+
+typedef struct Block {
+    uint64_t key;
+    int cycles;
+    int writeAddr;                           // where its last cycle writes, or -1
+    BlockCode code;
+} Block;
+
+
+struct Jit {
+    const Predecoded *pd;
+    uint8_t *code;
+    size_t used;
+    int count;
+    Block block[JIT_SLOTS];
+    uint8_t codePage[MEMORY_WORDS >> JIT_PAGE_SHIFT];
+};
+
+
+//
+// -- Where the code for a block is written
+//    -------------------------------------
+typedef struct Emitter {
+    uint8_t *p;
+    uint8_t *end;
+} Emitter;
+
+
+
+//
+// -- The raw bytes
+//    -------------
+static void Byte(Emitter *e, int b)
+{
+    if (e->p < e->end) *e->p = b;
+    e->p ++;
+}
+
+
+static void Bytes(Emitter *e, const uint8_t *b, int n)
+{
+    for (int i = 0; i < n; i ++) Byte(e, b[i]);
+}
+
+
+static void Imm16(Emitter *e, uint16_t v)
+{
+    Byte(e, v & 0xff);
+    Byte(e, v >> 8);
+}
+
+
+static void Imm32(Emitter *e, uint32_t v)
+{
+    for (int i = 0; i < 4; i ++) Byte(e, (v >> (i * 8)) & 0xff);
+}
+
+
+//
+// -- A ModRM for `[rdi + off]` (a field of the Cpu) with `reg` as the other operand (or opcode extension)
+//    ----------------------------------------------------------------------------------------------------
+static void Field(Emitter *e, int reg, int off)
+{
+    Byte(e, 0x80 | (reg << 3) | 7);
+    Imm32(e, off);
+}
+
+
+
+//
+// -- The instructions the blocks are made of
+//    ---------------------------------------
+static void LoadWord(Emitter *e, int reg, int off)          // movzx reg, word [rdi + off]
+{
+    Byte(e, 0x0f); Byte(e, 0xb7); Field(e, reg, off);
+}
+
+
+static void LoadImm(Emitter *e, int reg, uint32_t v)        // mov reg, v
+{
+    Byte(e, 0xb8 + reg); Imm32(e, v);
+}
+
+
+static void StoreWord(Emitter *e, int off)                  // mov [rdi + off], ax
+{
+    Byte(e, 0x66); Byte(e, 0x89); Field(e, EAX, off);
+}
+
+
+static void StoreImm(Emitter *e, int off, uint16_t v)       // mov word [rdi + off], v
+{
+    Byte(e, 0x66); Byte(e, 0xc7); Field(e, 0, off); Imm16(e, v);
+}
+
+
+static void Latch(Emitter *e, int off, uint8_t mask)        // [rdi + off] = [rdi + off] & ~mask | r8b & mask
+{
+    Byte(e, 0x80); Field(e, 4, off); Byte(e, ~mask & 0xff);            // and byte [rdi + off], ~mask
+    Byte(e, 0x44); Byte(e, 0x89); Byte(e, 0xc2);                        // mov edx, r8d
+    Byte(e, 0x83); Byte(e, 0xe2); Byte(e, mask);                        // and edx, mask
+    Byte(e, 0x08); Field(e, EDX, off);                                  // or [rdi + off], dl
+}
+
+
+
+//
+// -- Translate one cycle.  `pc` and `fetch` are known; `irAddr` is where the instruction came from, or -1 if it
+//    is only known when the block runs.
+//    ----------------------------------------------------------------------------------------------------------
+static void EmitCycle(Emitter *e, const MicroOp *op, uint16_t pc, uint16_t fetch, int irAddr)
+{
+    // -- the adder: ecx = ALUA + ALUB + carry, with the CPU flags in r8d
+    if (op->misc & MICRO_ALU) {
+        static const uint8_t add[] = {
+            0x66, 0x11, 0xd1,                                   // adc cx, dx
+            0x0f, 0x94, 0xc0,                                   // setz al
+            0x0f, 0x92, 0xc2,                                   // setc dl
+            0x41, 0x0f, 0x98, 0xc0,                             // sets r8b
+            0x41, 0x0f, 0x90, 0xc1,                             // seto r9b
+            0x41, 0x0f, 0x9c, 0xc2,                             // setl r10b
+            0x0f, 0xb7, 0xc9,                                   // movzx ecx, cx
+            0x0f, 0xb6, 0xc0,                                   // movzx eax, al          Z
+            0x0f, 0xb6, 0xd2, 0xd1, 0xe2, 0x09, 0xd0,           // eax |= dl << 1         C
+            0x41, 0x0f, 0xb6, 0xd0, 0xc1, 0xe2, 0x02, 0x09, 0xd0, // eax |= r8b << 2      N
+            0x41, 0x0f, 0xb6, 0xd1, 0xc1, 0xe2, 0x03, 0x09, 0xd0, // eax |= r9b << 3      V
+            0x41, 0x0f, 0xb6, 0xd2, 0xc1, 0xe2, 0x04, 0x09, 0xd0, // eax |= r10b << 4     L
+            0x41, 0x89, 0xc0,                                   // mov r8d, eax
+        };
+
+        LoadWord(e, ECX, op->aluA);
+
+        if (op->aluB == SRC_FETCH) LoadImm(e, EDX, fetch);
+        else LoadWord(e, EDX, op->aluB);
+
+        switch (op->carry) {
+        case 0:     Byte(e, 0xf8);          break;              // clc
+        case 3:     Byte(e, 0xf9);          break;              // stc
+        default:
+            Byte(e, 0x0f); Byte(e, 0xb6); Field(e, EAX, CPU_AT(pgmFlags));  // movzx eax, byte [pgmFlags]
+            Byte(e, 0xc1); Byte(e, 0xe8); Byte(e, 0x02);                    // shr eax, 2: CF = C
+            if (op->carry == 2) Byte(e, 0xf5);                              // cmc
+            break;
+        }
+
+        Bytes(e, add, sizeof(add));
+
+        if (op->pgmLatch) Latch(e, CPU_AT(pgmFlags), op->pgmLatch);
+        if (op->intLatch) Latch(e, CPU_AT(intFlags), op->intLatch);
+    }
+
+
+    // -- the main bus, in eax
+    if (op->src == SRC_FETCH) LoadImm(e, EAX, fetch);
+    else if (op->src == SRC_ALU) { Byte(e, 0x89); Byte(e, 0xc8); }                 // mov eax, ecx
+    else if (op->src == CPU_AT(pc)) LoadImm(e, EAX, pc);
+    else LoadWord(e, EAX, op->src);
+
+
+    // -- and everything which latches it
+    for (unsigned m = op->regLoad; m; m &= m - 1) StoreWord(e, CPU_REG(__builtin_ctz(m)));
+    for (unsigned m = op->devLoad; m; m &= m - 1) StoreWord(e, CPU_DEV(__builtin_ctz(m)));
+    for (unsigned m = op->ctlLoad; m; m &= m - 1) StoreWord(e, CPU_CTL(__builtin_ctz(m)));
+
+    if (op->misc & MICRO_WRITE) {                                                   // mov [rsi + pc * 2], ax
+        Byte(e, 0x66); Byte(e, 0x89); Byte(e, 0x86); Imm32(e, pc * 2);
+    }
+
+    if (op->misc & MICRO_CLC) { Byte(e, 0x80); Field(e, 4, CPU_AT(pgmFlags)); Byte(e, (uint8_t)~CPU_C); }
+    if (op->misc & MICRO_STC) { Byte(e, 0x80); Field(e, 1, CPU_AT(pgmFlags)); Byte(e, CPU_C); }
+
+    static const uint8_t counter[5] = { CPU_AT(ra), CPU_AT(sp), CPU_AT(intPc), CPU_AT(intRa), CPU_AT(intSp) };
+
+    for (int c = 0; c < 5; c ++) {
+        switch ((op->counters >> (c * 2)) & 3) {
+        case 1:     StoreWord(e, counter[c]);                                           break;
+        case 2:     Byte(e, 0x66); Byte(e, 0x83); Field(e, 0, counter[c]); Byte(e, 1);  break;     // add word, 1
+        case 3:     Byte(e, 0x66); Byte(e, 0x83); Field(e, 5, counter[c]); Byte(e, 1);  break;     // sub word, 1
+        }
+    }
+
+    if (op->pcOp == 1) {
+        if (irAddr < 0) { Byte(e, 0x66); Byte(e, 0x3b); Field(e, EAX, CPU_AT(irAddr)); }   // cmp ax, [irAddr]
+        else { Byte(e, 0x66); Byte(e, 0x3d); Imm16(e, irAddr); }                            // cmp ax, irAddr
+        Byte(e, 0x0f); Byte(e, 0x94); Field(e, 0, CPU_AT(halted));                         // sete [halted]
+        StoreWord(e, CPU_AT(pc));
+    }
+}
+
+
+
+//
+// -- Throw every block away
+//    ----------------------
+static void FlushJit(Jit *jit)
+{
+    for (int s = 0; s < JIT_SLOTS; s ++) jit->block[s].key = JIT_EMPTY;
+
+    memset(jit->codePage, 0, sizeof(jit->codePage));
+    jit->used = 0;
+    jit->count = 0;
+}
+
+
+
+//
+// -- The state a block starts from, and the block for it (or the empty slot where it goes)
+//    -------------------------------------------------------------------------------------
+static inline uint64_t BlockKey(const Jit *jit, const Cpu *cpu)
+{
+    int notMet = !((jit->pd->met[cpu->ir >> 12] >> cpu->pgmFlags) & 1);
+
+    return ((uint64_t)cpu->pc << 17) | ((uint64_t)cpu->ir << 1) | notMet;
+}
+
+
+static inline Block *FindBlock(Jit *jit, uint64_t key)
+{
+    int s = (key * 0x9e3779b97f4a7c15ull) >> 51;
+
+    while (jit->block[s].key != JIT_EMPTY && jit->block[s].key != key) s = (s + 1) & (JIT_SLOTS - 1);
+
+    return &jit->block[s];
+}
+
+
+
+//
+// -- Translate the block which starts from the machine as it is now
+//    --------------------------------------------------------------
+static Block *Translate(Jit *jit, Cpu *cpu, uint64_t key)
+{
+    if (jit->count >= JIT_MAX_BLOCKS || jit->used + JIT_MAX_BLOCK_CODE > JIT_CODE_SIZE) FlushJit(jit);
+
+    Block *block = FindBlock(jit, key);
+    const Predecoded *pd = jit->pd;
+    Emitter e = { jit->code + jit->used, jit->code + JIT_CODE_SIZE };
+    uint16_t pc = cpu->pc;
+    uint16_t ir = cpu->ir;
+    int irAddr = -1;
+    bool loaded = false;
+
+    block->key = key;
+    block->cycles = 0;
+    block->writeAddr = -1;
+    block->code = (BlockCode)e.p;
+    jit->count ++;
+
+    if (mprotect(jit->code, JIT_CODE_SIZE, PROT_READ | PROT_WRITE) != 0) return block;
+
+    while (block->cycles < JIT_MAX_CYCLES) {
+        int cond = ir >> 12;
+        int notMet;
+
+        if (block->cycles == 0) notMet = key & 1;
+        else if (cond == COND_ALWAYS) notMet = 0;
+        else if (cond > COND_NL) notMet = 1;
+        else break;
+
+        const MicroOp *op = &pd->op[pd->index[ir & (INSTR_COUNT - 1)][notMet]];
+
+        if (op->addr != CPU_AT(pc)) break;
+
+        uint16_t fetch = cpu->mem[pc];
+
+        jit->codePage[pc >> JIT_PAGE_SHIFT] = 1;
+        EmitCycle(&e, op, pc, fetch, irAddr);
+        block->cycles ++;
+
+        if (op->misc & MICRO_SUPPRESS) {
+            ir = OPCODE_NOP;
+        } else {
+            ir = fetch;
+            irAddr = pc;
+        }
+
+        if (op->misc & MICRO_WRITE) block->writeAddr = pc;
+
+        if (op->pcOp == 1) {
+            loaded = true;
+            break;
+        }
+
+        pc = CountOp(pc, op->pcOp, 0);
+
+        if (op->misc & MICRO_WRITE) break;
+    }
+
+    if (block->cycles) {
+        if (!loaded) StoreImm(&e, CPU_AT(pc), pc);
+        StoreImm(&e, CPU_AT(ir), ir);
+        if (irAddr >= 0) StoreImm(&e, CPU_AT(irAddr), irAddr);
+        Byte(&e, 0xc3);                                                 // ret
+
+        jit->used = e.p - jit->code;
+    }
+
+    if (mprotect(jit->code, JIT_CODE_SIZE, PROT_READ | PROT_EXEC) != 0) block->cycles = 0;
+
+    return block;
+}
+
+
+
+//
+// -- Set up the JIT, with its code mapped
+//    ------------------------------------
+Jit *OpenJit(const Predecoded *pd)
+{
+    Jit *jit = (Jit *)malloc(sizeof(Jit));
+
+    if (!jit) return NULL;
+
+    jit->pd = pd;
+    jit->code = (uint8_t *)mmap(NULL, JIT_CODE_SIZE, PROT_READ | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (jit->code == MAP_FAILED) {
+        free(jit);
+        return NULL;
+    }
+
+    FlushJit(jit);
+
+    return jit;
+}
+
+
+void CloseJit(Jit *jit)
+{
+    munmap(jit->code, JIT_CODE_SIZE);
+    free(jit);
+}
+
+
+void ResetJit(Jit *jit)
+{
+    FlushJit(jit);
+}
+
+
+
+//
+// -- Run until the machine halts or `limit` cycles have gone by
+//    ----------------------------------------------------------
+uint64_t RunJit(Jit *jit, Cpu *cpu, uint64_t limit)
+{
+    uint64_t start = cpu->cycles;
+
+    while (!cpu->halted && cpu->cycles - start < limit) {
+        uint64_t key = BlockKey(jit, cpu);
+        Block *block = FindBlock(jit, key);
+
+        if (block->key == JIT_EMPTY) block = Translate(jit, cpu, key);
+
+        if (block->cycles && (uint64_t)block->cycles <= limit - (cpu->cycles - start)) {
+            block->code(cpu, cpu->mem);
+            cpu->cycles += block->cycles;
+
+            if (block->writeAddr >= 0 && jit->codePage[block->writeAddr >> JIT_PAGE_SHIFT]) FlushJit(jit);
+
+            continue;
+        }
+
+
+        // -- one cycle the slow way, watching where it writes
+        const MicroOp *op = CurrentOp(jit->pd, cpu);
+        int writeAddr = (op->misc & MICRO_WRITE) ? CPU_WORD(cpu, op->addr) : -1;
+
+        RunPredecoded(cpu, jit->pd, 1);
+
+        if (writeAddr >= 0 && jit->codePage[writeAddr >> JIT_PAGE_SHIFT]) FlushJit(jit);
+    }
+
+    return cpu->cycles - start;
+}
+
+
+#else
+
+//
+// -- There is no JIT for anything else
+//    ---------------------------------
+Jit *OpenJit(const Predecoded *)
+{
+    return NULL;
+}
+
+
+void CloseJit(Jit *)
+{
+}
+
+
+void ResetJit(Jit *)
+{
+}
+
+
+uint64_t RunJit(Jit *, Cpu *, uint64_t)
+{
+    return 0;
+}
+
+#endif
@@ -0,0 +1,179 @@
+//===================================================================================================================
+//  liveness.cc -- Find the control bits, and the whole EEPROMs, which never change
+//
+//  A bit which has the same value at every address carries nothing: its line can be tied high or low on the
+//  board.  When all 8 bits of an EEPROM are like that, the EEPROM itself carries nothing and does not need to be
+//  programmed (or even fitted).  For each bit, the number of times it toggles between one address and the next
+//  is also counted, as a rough measure of how much it is used.
+//
+//  Pruning works from the images once they are written (whichever way that happened), after the package and the
+//  store have a complete record of the build: the images of the EEPROMs which carry nothing are removed, along
+//  with their text images and plans, so `upload` and `verify` skip them.
+//
+//  -----------------------------------------------------------------------------------------------------------------
+//
+//     Date      Tracker  Version  Pgmr  Description
+//  -----------  -------  -------  ----  ---------------------------------------------------------------------------
+//  2026-Oct-16  Initial  v0.0.1   ADCL  Initial version
+//
+//===================================================================================================================
+
+
+#include <cstdint>
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <errno.h>
+#include <unistd.h>
+
+#include "eeprom.h"
+
+
+
+//
+// -- The files written for each lane besides its image, which go with it when it is pruned
+//    -------------------------------------------------------------------------------------
+static const char *sideFile[] = { ".hex", ".srec", ".plan" };
+
+
+
+//
+// -- Work out the bits of a lane which never change (and their value), and how often each bit toggles
+//    ------------------------------------------------------------------------------------------------
+static uint8_t AnalyseLane(const uint8_t *lane, int size, uint8_t *value, int toggles[8])
+{
+    static int count[256];
+    uint8_t all = 0xff;
+    uint8_t any = 0;
+
+    memset(count, 0, sizeof(count));
+
+    for (int i = 0; i < size; i ++) {
+        all &= lane[i];
+        any |= lane[i];
+    }
+
+    for (int i = 1; i < size; i ++) count[lane[i] ^ lane[i - 1]] ++;
+
+    for (int b = 0; b < 8; b ++) {
+        toggles[b] = 0;
+
+        for (int v = 1; v < 256; v ++) {
+            if (v & (1 << b)) toggles[b] += count[v];
+        }
+    }
+
+    *value = all;
+
+    return ~(all ^ any);
+}
+
+
+
+//
+// -- Find the lanes which carry something; with `report`, print every bit of every lane
+//    ----------------------------------------------------------------------------------
+uint32_t LiveLanes(const uint8_t *const lanes[CTRL_LANES], int size, bool report)
+{
+    uint32_t live = 0;
+    int deadBits = 0;
+    int deadLanes = 0;
+
+    if (report) {
+        printf("EEPROM     carries   bit 7   bit 6   bit 5   bit 4   bit 3   bit 2   bit 1   bit 0\n");
+        printf("---------  -------  ------  ------  ------  ------  ------  ------  ------  ------\n");
+    }
+
+    for (int l = 0; l < CTRL_LANES; l ++) {
+        int toggles[8];
+        uint8_t value;
+        uint8_t constant = AnalyseLane(lanes[l], size, &value, toggles);
+
+        if (constant != 0xff) live |= 1u << l;
+        else deadLanes ++;
+
+        for (int b = 0; b < 8; b ++) deadBits += (constant >> b) & 1;
+
+        if (!report) continue;
+
+        // -- each bit is either the number of times it toggles, or `=0`/`=1` if it never does
+        if (constant == 0xff) printf("%-9s  nothing", laneFile[l]);
+        else printf("%-9s  %7s", laneFile[l], "");
+
+        for (int b = 7; b >= 0; b --) {
+            if (constant & (1 << b)) printf("  %6s", (value & (1 << b)) ? "=1" : "=0");
+            else printf("  %6d", toggles[b]);
+        }
+
+        printf("\n");
+    }
+
+    if (report) {
+        printf("\n%d of %d bit(s) never change; %d of %d EEPROM(s) carry nothing:", deadBits, CTRL_LANES * 8,
+                deadLanes, CTRL_LANES);
+
+        for (int l = 0; l < CTRL_LANES; l ++) {
+            if (!(live & (1u << l))) printf(" %s", laneFile[l]);
+        }
+
+        printf("\n");
+    }
+
+    return live;
+}
+
+
+
+//
+// -- Remove the images (and their text images and plans) of the lanes in `dir` which carry nothing
+//    ---------------------------------------------------------------------------------------------
+bool PruneImages(const char *dir, int size)
+{
+    char path[FILENAME_MAX];
+    uint8_t *image = (uint8_t *)malloc((size_t)size * CTRL_LANES);
+    uint8_t *lanes[CTRL_LANES];
+
+    if (!image) {
+        fprintf(stderr, "Out of memory\n");
+        return false;
+    }
+
+    for (int l = 0; l < CTRL_LANES; l ++) {
+        lanes[l] = image + (size_t)l * size;
+
+        if (!ReadImage(dir, l, lanes[l], size)) {
+            free(image);
+            return false;
+        }
+    }
+
+    uint32_t live = LiveLanes(lanes, size, false);
+    bool ok = true;
+
+    for (int l = 0; l < CTRL_LANES; l ++) {
+        if (live & (1u << l)) continue;
+
+        LanePath(path, sizeof(path), dir, l);
+
+        if (unlink(path) != 0) {
+            fprintf(stderr, "Unable to remove %s: %s\n", path, strerror(errno));
+            ok = false;
+            continue;
+        }
+
+        for (size_t s = 0; s < sizeof(sideFile) / sizeof(sideFile[0]); s ++) {
+            LaneSidePath(path, sizeof(path), dir, l, sideFile[s]);
+
+            if (unlink(path) != 0 && errno != ENOENT) {
+                fprintf(stderr, "Unable to remove %s: %s\n", path, strerror(errno));
+                ok = false;
+            }
+        }
+
+        printf("%s: always 0x%02x; not written (tie its outputs instead)\n", laneFile[l], lanes[l][0]);
+    }
+
+    free(image);
+
+    return ok;
+}
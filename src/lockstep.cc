@@ -0,0 +1,659 @@
+//===================================================================================================================
+//  lockstep.cc -- Run 16 machines at once, one to each lane of a vector, and sweep a routine over its inputs
+//
+//  A short routine is best tested by running it for every input (or a great many random ones).  Those runs all
+//  start at the same place and mostly stay together, so they are run side by side in a CpuBatch: each register,
+//  and each word of memory, holds the value for all 16 machines in one 256-bit vector.  When every machine which
+//  is still running is at the same instruction, with the same outcome for its condition, and puts the same
+//  address on address bus 1, the cycle is done once with vector operations for all of them (the adder and its
+//  flags included).  When they have gone their own ways, each runs its cycle by itself until they meet up again.
+//
+//  The vector code is written with the compiler's vector types, so it builds anywhere; on x86-64 it is also
+//  built for AVX2, which is used when the cpu has it.
+//
+//  `eeprom sweep` runs a program once for every value of an input register (or for random values of several),
+//  16 at a time, and reports the cycles they took; `--table` writes each input with the registers it ended with.
+//
+//  -----------------------------------------------------------------------------------------------------------------
+//
+//     Date      Tracker  Version  Pgmr  Description
+//  -----------  -------  -------  ----  ---------------------------------------------------------------------------
+//  2026-Oct-16  Initial  v0.0.1   ADCL  Initial version
+//
+//===================================================================================================================
+
+
+#include <cstdint>
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <errno.h>
+#include <time.h>
+
+#include "sim.h"
+#include "microcode.h"
+
+
+
+//
+// -- 16 machines' worth of one register.  These are only ever passed between inlined functions here, so the
+//    warning about the ABI for passing them without AVX does not apply
+//    ------------------------------------------------------------------------------------------------------
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+typedef uint16_t Vec __attribute__((vector_size(sizeof(LaneWords))));
+
+
+
+//
+// -- Where each register of a Cpu (as a MicroOp names it) lives in a CpuBatch
+//    ------------------------------------------------------------------------
+typedef struct RowTable {
+    uint16_t off[256];
+} RowTable;
+
+
+constexpr RowTable BuildRowTable(void)
+{
+    RowTable t {};
+
+    for (int n = 0; n < REGISTERS; n ++) t.off[CPU_REG(n)] = offsetof(CpuBatch, r) + n * sizeof(LaneWords);
+
+    for (int n = 0; n <= DEVICES; n ++) {
+        t.off[CPU_DEV(n)] = offsetof(CpuBatch, dev) + n * sizeof(LaneWords);
+        t.off[CPU_CTL(n)] = offsetof(CpuBatch, ctl) + n * sizeof(LaneWords);
+    }
+
+    t.off[CPU_AT(pc)] = offsetof(CpuBatch, pc);
+    t.off[CPU_AT(ra)] = offsetof(CpuBatch, ra);
+    t.off[CPU_AT(sp)] = offsetof(CpuBatch, sp);
+    t.off[CPU_AT(intPc)] = offsetof(CpuBatch, intPc);
+    t.off[CPU_AT(intRa)] = offsetof(CpuBatch, intRa);
+    t.off[CPU_AT(intSp)] = offsetof(CpuBatch, intSp);
+
+    return t;
+}
+
+
+inline constexpr RowTable rowTable = BuildRowTable();
+
+
+static inline uint16_t *Row(CpuBatch *b, uint8_t off)
+{
+    return (uint16_t *)((uint8_t *)b + rowTable.off[off]);
+}
+
+
+static inline Vec Load(const uint16_t *p)
+{
+    Vec v;
+
+    memcpy(&v, p, sizeof(v));
+
+    return v;
+}
+
+
+static inline void Store(uint16_t *p, const Vec &v, const Vec &mask)
+{
+    Vec w = (v & mask) | (Load(p) & ~mask);
+
+    memcpy(p, &w, sizeof(w));
+}
+
+
+
+//
+// -- The MicroOp for one machine's next cycle
+//    ----------------------------------------
+static inline const MicroOp *LaneOp(const Predecoded *pd, const CpuBatch *b, int l)
+{
+    uint16_t ir = b->ir[l];
+
+    return &pd->op[pd->index[ir & (INSTR_COUNT - 1)][!((pd->met[ir >> 12] >> b->pgmFlags[l]) & 1)]];
+}
+
+
+static inline void Dirty(CpuBatch *b, int addr)
+{
+    if (addr < b->dirtyLo) b->dirtyLo = addr;
+    if (addr > b->dirtyHi) b->dirtyHi = addr;
+}
+
+
+
+//
+// -- One cycle of one machine, as RunPredecoded() does it
+//    ----------------------------------------------------
+static void LaneCycle(CpuBatch *b, const Predecoded *pd, int l)
+{
+    const MicroOp *op = LaneOp(pd, b, l);
+    uint16_t addr = Row(b, op->addr)[l];
+    uint16_t fetch = b->mem[addr][l];
+    uint16_t sum = 0;
+    uint8_t aluFlags = 0;
+
+    if (op->misc & MICRO_ALU) {
+        uint16_t bv = op->aluB == SRC_FETCH ? fetch : Row(b, op->aluB)[l];
+        int c = (b->pgmFlags[l] & CPU_C) ? 1 : 0;
+        int carry = op->carry == 0 ? 0 : op->carry == 1 ? c : op->carry == 2 ? !c : 1;
+
+        sum = Adder(Row(b, op->aluA)[l], bv, carry, &aluFlags);
+    }
+
+    uint16_t bus = op->src == SRC_FETCH ? fetch : op->src == SRC_ALU ? sum : Row(b, op->src)[l];
+
+    for (unsigned m = op->regLoad; m; m &= m - 1) b->r[__builtin_ctz(m)][l] = bus;
+    for (unsigned m = op->devLoad; m; m &= m - 1) b->dev[__builtin_ctz(m)][l] = bus;
+    for (unsigned m = op->ctlLoad; m; m &= m - 1) b->ctl[__builtin_ctz(m)][l] = bus;
+
+    if (op->misc & MICRO_WRITE) {
+        b->mem[addr][l] = bus;
+        Dirty(b, addr);
+    }
+
+    b->pgmFlags[l] = (b->pgmFlags[l] & ~op->pgmLatch) | (aluFlags & op->pgmLatch);
+    b->intFlags[l] = (b->intFlags[l] & ~op->intLatch) | (aluFlags & op->intLatch);
+
+    if (op->misc & MICRO_CLC) b->pgmFlags[l] &= ~CPU_C;
+    if (op->misc & MICRO_STC) b->pgmFlags[l] |= CPU_C;
+
+    if (op->pcOp == 1 && bus == b->irAddr[l]) b->halting |= 1u << l;
+
+    b->pc[l] = CountOp(b->pc[l], op->pcOp, bus);
+    b->ra[l] = CountOp(b->ra[l], op->counters & 3, bus);
+    b->sp[l] = CountOp(b->sp[l], (op->counters >> 2) & 3, bus);
+    b->intPc[l] = CountOp(b->intPc[l], (op->counters >> 4) & 3, bus);
+    b->intRa[l] = CountOp(b->intRa[l], (op->counters >> 6) & 3, bus);
+    b->intSp[l] = CountOp(b->intSp[l], (op->counters >> 8) & 3, bus);
+
+    if (op->misc & MICRO_SUPPRESS) {
+        b->ir[l] = OPCODE_NOP;
+    } else {
+        b->ir[l] = fetch;
+        b->irAddr[l] = addr;
+    }
+}
+
+
+
+//
+// -- Load, count up or count down a counter register of every machine in `m`
+//    -----------------------------------------------------------------------
+static inline __attribute__((always_inline)) void VecCount(uint16_t *row, int op, const Vec &bus, const Vec &m)
+{
+    switch (op) {
+    case 1:     Store(row, bus, m);                 break;
+    case 2:     Store(row, Load(row) + 1, m);       break;
+    case 3:     Store(row, Load(row) - 1, m);       break;
+    }
+}
+
+
+
+//
+// -- One cycle of every machine in `lanes`, which all run `op` with `addr` on address bus 1
+//    --------------------------------------------------------------------------------------
+static inline __attribute__((always_inline)) void VecCycle(CpuBatch *b, const MicroOp *op, uint16_t addr,
+        uint32_t lanes)
+{
+    Vec m;
+
+    for (int l = 0; l < SIMD_LANES; l ++) m[l] = (lanes >> l) & 1 ? 0xffff : 0;
+
+    Vec fetch = Load(b->mem[addr]);
+    Vec sum = {};
+    Vec aluFlags = {};
+
+
+    // -- the adder, and its flags worked out from the top bits of the inputs and the sum
+    if (op->misc & MICRO_ALU) {
+        Vec a = Load(Row(b, op->aluA));
+        Vec bv = op->aluB == SRC_FETCH ? fetch : Load(Row(b, op->aluB));
+        Vec c = (Load(b->pgmFlags) >> 1) & 1;
+        Vec carry = op->carry == 0 ? c & 0 : op->carry == 1 ? c : op->carry == 2 ? c ^ 1 : (c | 1);
+
+        sum = a + bv + carry;
+
+        Vec z = (Vec)(sum == 0) & 1;
+        Vec co = ((a & bv) | ((a | bv) & ~sum)) >> 15;
+        Vec n = sum >> 15;
+        Vec v = (~(a ^ bv) & (a ^ sum)) >> 15;
+
+        aluFlags = z | (co << 1) | (n << 2) | (v << 3) | ((n ^ v) << 4);
+
+        if (op->pgmLatch) Store(b->pgmFlags, (Load(b->pgmFlags) & (uint16_t)~op->pgmLatch) | (aluFlags & op->pgmLatch),
+                m);
+        if (op->intLatch) Store(b->intFlags, (Load(b->intFlags) & (uint16_t)~op->intLatch) | (aluFlags & op->intLatch),
+                m);
+    }
+
+
+    // -- the main bus, and everything which latches it
+    Vec bus = op->src == SRC_FETCH ? fetch : op->src == SRC_ALU ? sum : Load(Row(b, op->src));
+
+    for (unsigned r = op->regLoad; r; r &= r - 1) Store(b->r[__builtin_ctz(r)], bus, m);
+    for (unsigned r = op->devLoad; r; r &= r - 1) Store(b->dev[__builtin_ctz(r)], bus, m);
+    for (unsigned r = op->ctlLoad; r; r &= r - 1) Store(b->ctl[__builtin_ctz(r)], bus, m);
+
+    if (op->misc & MICRO_WRITE) {
+        Store(b->mem[addr], bus, m);
+        Dirty(b, addr);
+    }
+
+    if (op->misc & MICRO_CLC) Store(b->pgmFlags, Load(b->pgmFlags) & (uint16_t)~CPU_C, m);
+    if (op->misc & MICRO_STC) Store(b->pgmFlags, Load(b->pgmFlags) | (uint16_t)CPU_C, m);
+
+    if (op->pcOp == 1) {
+        Vec halt = (Vec)(bus == Load(b->irAddr)) & m;
+
+        for (int l = 0; l < SIMD_LANES; l ++) {
+            if (halt[l]) b->halting |= 1u << l;
+        }
+    }
+
+    VecCount(b->pc, op->pcOp, bus, m);
+
+    if (op->counters) {
+        VecCount(b->ra, op->counters & 3, bus, m);
+        VecCount(b->sp, (op->counters >> 2) & 3, bus, m);
+        VecCount(b->intPc, (op->counters >> 4) & 3, bus, m);
+        VecCount(b->intRa, (op->counters >> 6) & 3, bus, m);
+        VecCount(b->intSp, (op->counters >> 8) & 3, bus, m);
+    }
+
+    if (op->misc & MICRO_SUPPRESS) {
+        Store(b->ir, (Vec){} + (uint16_t)OPCODE_NOP, m);
+    } else {
+        Store(b->ir, fetch, m);
+        Store(b->irAddr, (Vec){} + addr, m);
+    }
+}
+
+
+typedef void (*VecCycleFn)(CpuBatch *b, const MicroOp *op, uint16_t addr, uint32_t lanes);
+
+static void VecCycleGeneric(CpuBatch *b, const MicroOp *op, uint16_t addr, uint32_t lanes)
+{
+    VecCycle(b, op, addr, lanes);
+}
+
+#if defined(__x86_64__)
+__attribute__((target("avx2"))) static void VecCycleAvx2(CpuBatch *b, const MicroOp *op, uint16_t addr,
+        uint32_t lanes)
+{
+    VecCycle(b, op, addr, lanes);
+}
+#endif
+
+
+
+//
+// -- Start every machine in `lanes` at `pc`
+//    --------------------------------------
+void ResetBatch(CpuBatch *b, LaneWords *mem, uint16_t pc, uint32_t lanes)
+{
+    memset(b, 0, sizeof(CpuBatch));
+
+    b->mem = mem;
+    b->active = lanes;
+    b->dirtyLo = MEMORY_WORDS;
+    b->dirtyHi = -1;
+
+    for (int l = 0; l < SIMD_LANES; l ++) {
+        b->pc[l] = pc;
+        b->ir[l] = OPCODE_NOP;
+        b->irAddr[l] = pc;
+    }
+}
+
+
+
+//
+// -- Run until every machine halts or `limit` cycles have gone by
+//    ------------------------------------------------------------
+uint64_t RunBatch(CpuBatch *b, const Predecoded *pd, uint64_t limit)
+{
+    VecCycleFn cycle = VecCycleGeneric;
+    uint64_t start = b->cycle;
+
+#if defined(__x86_64__)
+    if (__builtin_cpu_supports("avx2")) cycle = VecCycleAvx2;
+#endif
+
+    while (b->active && b->cycle - start < limit) {
+        int first = __builtin_ctz(b->active);
+        const MicroOp *op = LaneOp(pd, b, first);
+        uint16_t *addrRow = Row(b, op->addr);
+        uint16_t ir = b->ir[first];
+        uint16_t flags = b->pgmFlags[first];
+        bool together = true;
+
+        // -- the same instruction, flags which give the same MicroOp and the same address is enough
+        for (uint32_t m = b->active & (b->active - 1); m && together; m &= m - 1) {
+            int l = __builtin_ctz(m);
+
+            together = b->ir[l] == ir && addrRow[l] == addrRow[first] &&
+                    (b->pgmFlags[l] == flags || LaneOp(pd, b, l) == op);
+        }
+
+        if (together) {
+            cycle(b, op, addrRow[first], b->active);
+        } else {
+            for (uint32_t m = b->active; m; m &= m - 1) LaneCycle(b, pd, __builtin_ctz(m));
+            b->divergent ++;
+        }
+
+        b->cycle ++;
+
+        for (uint32_t m = b->halting; m; m &= m - 1) b->cycles[__builtin_ctz(m)] = b->cycle;
+
+        b->active &= ~b->halting;
+        b->halting = 0;
+    }
+
+    for (uint32_t m = b->active; m; m &= m - 1) b->cycles[__builtin_ctz(m)] = b->cycle;
+
+    return b->cycle - start;
+}
+
+
+
+//
+// -- What a sweep was asked to do
+//    ----------------------------
+typedef struct Sweeping {
+    const char *program;
+    const char *microcode;
+    const char *images;
+    const char *table;
+    int in[REGISTERS];                       // the input registers
+    int inputs;
+    uint64_t count;                          // the number of runs
+    bool random;                             // random inputs (or every value of one register)
+    uint64_t seed;
+    uint64_t limit;
+    long at;
+    bool check;
+} Sweeping;
+
+
+
+//
+// -- The inputs for run `n`
+//    ----------------------
+static uint64_t Mix(uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ull;
+
+    return x ^ (x >> 33);
+}
+
+
+static uint16_t InputValue(const Sweeping *sw, uint64_t n, int i)
+{
+    return sw->random ? Mix(sw->seed ^ Mix(n * REGISTERS + i)) : n;
+}
+
+
+
+//
+// -- Parse `R1,R2,...`
+//    -----------------
+static bool ParseRegisters(const char *list, Sweeping *sw)
+{
+    const char *p = list;
+
+    sw->inputs = 0;
+
+    while (*p) {
+        char *end;
+
+        if (*p != 'R' && *p != 'r') return false;
+
+        long r = strtol(p + 1, &end, 10);
+
+        if (end == p + 1 || r < 1 || r >= REGISTERS || sw->inputs >= REGISTERS - 1) return false;
+
+        sw->in[sw->inputs ++] = r;
+        p = end;
+
+        if (*p == ',') p ++;
+        else if (*p) return false;
+    }
+
+    return sw->inputs > 0;
+}
+
+
+
+//
+// -- Check one machine of a batch against the same run on the plain predecoded machine
+//    ---------------------------------------------------------------------------------
+static bool CheckLane(const Sweeping *sw, const Predecoded *pd, CpuBatch *b, int l, const uint16_t *pristine,
+        uint16_t *scratch, uint64_t n)
+{
+    Cpu cpu;
+
+    memcpy(scratch, pristine, MEMORY_WORDS * sizeof(uint16_t));
+    ResetCpu(&cpu, scratch, sw->at);
+
+    for (int i = 0; i < sw->inputs; i ++) cpu.r[sw->in[i]] = InputValue(sw, n, i);
+
+    RunPredecoded(&cpu, pd, sw->limit);
+
+    bool same = cpu.cycles == b->cycles[l] && cpu.halted == !(b->active & (1u << l)) && cpu.pc == b->pc[l] &&
+            cpu.ra == b->ra[l] && cpu.sp == b->sp[l] && cpu.intPc == b->intPc[l] && cpu.intRa == b->intRa[l] &&
+            cpu.intSp == b->intSp[l] && cpu.ir == b->ir[l] && cpu.irAddr == b->irAddr[l] &&
+            cpu.pgmFlags == b->pgmFlags[l] && cpu.intFlags == b->intFlags[l];
+
+    for (int r = 1; r < REGISTERS; r ++) same = same && cpu.r[r] == b->r[r][l];
+
+    for (int d = 1; d <= DEVICES; d ++) same = same && cpu.dev[d] == b->dev[d][l] && cpu.ctl[d] == b->ctl[d][l];
+
+    for (int a = 0; a < MEMORY_WORDS; a ++) same = same && scratch[a] == b->mem[a][l];
+
+    if (!same) fprintf(stderr, "%s: run %llu differs from the plain simulator\n", sw->program, (unsigned long long)n);
+
+    return same;
+}
+
+
+
+//
+// -- Write one run to the table
+//    --------------------------
+static void TableLine(FILE *fp, const Sweeping *sw, const CpuBatch *b, int l, uint64_t n)
+{
+    static const char flagName[] = "ZCNVL";
+
+    for (int i = 0; i < sw->inputs; i ++) fprintf(fp, "R%d=0x%04x ", sw->in[i], InputValue(sw, n, i));
+
+    fprintf(fp, "->");
+
+    for (int r = 1; r < REGISTERS; r ++) fprintf(fp, " 0x%04x", b->r[r][l]);
+
+    fprintf(fp, "  ");
+
+    for (int f = 0; f < 5; f ++) fputc((b->pgmFlags[l] & (1 << f)) ? flagName[f] : '-', fp);
+
+    fprintf(fp, "  %llu%s\n", (unsigned long long)b->cycles[l], (b->active & (1u << l)) ? " still running" : "");
+}
+
+
+
+//
+// -- Run every input through the batches
+//    -----------------------------------
+static bool RunSweep(const Sweeping *sw, const Predecoded *pd, const uint16_t *pristine, LaneWords *mem, FILE *table)
+{
+    static CpuBatch b;
+    uint16_t *scratch = sw->check ? (uint16_t *)malloc(MEMORY_WORDS * sizeof(uint16_t)) : NULL;
+    uint64_t halted = 0, total = 0, divergent = 0, batchCycles = 0;
+    uint64_t least = UINT64_MAX, most = 0;
+    double secs = 0;
+    bool ok = true;
+
+    if (sw->check && !scratch) {
+        fprintf(stderr, "Out of memory\n");
+        return false;
+    }
+
+    for (uint64_t first = 0; first < sw->count; first += SIMD_LANES) {
+        int lanes = sw->count - first < (uint64_t)SIMD_LANES ? sw->count - first : SIMD_LANES;
+
+        ResetBatch(&b, mem, sw->at, (1u << lanes) - 1);
+
+        for (int l = 0; l < lanes; l ++) {
+            for (int i = 0; i < sw->inputs; i ++) b.r[sw->in[i]][l] = InputValue(sw, first + l, i);
+        }
+
+        // -- only the batch itself is timed; the table and the checks are not
+        struct timespec start, end;
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        RunBatch(&b, pd, sw->limit);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        secs += (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+        batchCycles += b.cycle;
+        divergent += b.divergent;
+
+        for (int l = 0; l < lanes; l ++) {
+            total += b.cycles[l];
+
+            if (!(b.active & (1u << l))) {
+                halted ++;
+                if (b.cycles[l] < least) least = b.cycles[l];
+                if (b.cycles[l] > most) most = b.cycles[l];
+            }
+
+            if (table) TableLine(table, sw, &b, l, first + l);
+            if (sw->check && !CheckLane(sw, pd, &b, l, pristine, scratch, first + l)) ok = false;
+        }
+
+
+        // -- put back whatever the batch wrote
+        for (int a = b.dirtyLo; a <= b.dirtyHi; a ++) {
+            for (int l = 0; l < SIMD_LANES; l ++) mem[a][l] = pristine[a];
+        }
+    }
+
+    printf("%s: %llu run(s), %llu halted", sw->program, (unsigned long long)sw->count, (unsigned long long)halted);
+
+    if (halted) printf(" in %llu to %llu cycle(s)", (unsigned long long)least, (unsigned long long)most);
+
+    printf(", %llu still running after %llu\n", (unsigned long long)(sw->count - halted),
+            (unsigned long long)sw->limit);
+    printf("%.3f s, %.0f runs a second, %.1f million machine cycles a second; %.1f%% of cycles diverged\n",
+            secs, secs > 0 ? sw->count / secs : 0.0, secs > 0 ? total / secs / 1e6 : 0.0,
+            batchCycles ? 100.0 * divergent / batchCycles : 0.0);
+
+    if (sw->check && ok) printf("Every run matches the plain simulator\n");
+
+    free(scratch);
+
+    return ok;
+}
+
+
+
+//
+// -- The `sweep` subcommand: run a program for every value of an input register, or for random inputs
+//    ------------------------------------------------------------------------------------------------
+int Sweep(const char *pgm, int argc, char *argv[])
+{
+    Sweeping sw;
+    bool usage = false;
+
+    memset(&sw, 0, sizeof(sw));
+    sw.limit = 1000000;
+
+    for (int i = 0; i < argc && !usage; i ++) {
+        if (strcmp(argv[i], "--in") == 0 && i + 1 < argc) {
+            usage = !ParseRegisters(argv[++ i], &sw);
+        } else if (strcmp(argv[i], "--random") == 0 && i + 1 < argc) {
+            sw.random = true;
+            sw.count = strtoull(argv[++ i], NULL, 0);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            sw.seed = strtoull(argv[++ i], NULL, 0);
+        } else if (strcmp(argv[i], "--microcode") == 0 && i + 1 < argc) {
+            sw.microcode = argv[++ i];
+        } else if (strcmp(argv[i], "--images") == 0 && i + 1 < argc) {
+            sw.images = argv[++ i];
+        } else if (strcmp(argv[i], "--cycles") == 0 && i + 1 < argc) {
+            sw.limit = strtoull(argv[++ i], NULL, 0);
+        } else if (strcmp(argv[i], "--at") == 0 && i + 1 < argc) {
+            sw.at = strtol(argv[++ i], NULL, 0);
+        } else if (strcmp(argv[i], "--table") == 0 && i + 1 < argc) {
+            sw.table = argv[++ i];
+        } else if (strcmp(argv[i], "--check") == 0) {
+            sw.check = true;
+        } else if (argv[i][0] != '-' && !sw.program) {
+            sw.program = argv[i];
+        } else {
+            usage = true;
+        }
+    }
+
+    if (!usage && !sw.random) {
+        if (sw.inputs != 1) {
+            fprintf(stderr, "%s: every value of more than one register is too many; use --random <n>\n", pgm);
+            return EXIT_FAILURE;
+        }
+
+        sw.count = MEMORY_WORDS;
+    }
+
+    if (usage || !sw.program || !sw.inputs || !sw.count || (sw.microcode && sw.images) || sw.at < 0 ||
+            sw.at >= MEMORY_WORDS) {
+        fprintf(stderr, "Usage: %s sweep <program> --in R<n>[,R<n>...] [--random <n> [--seed <n>]]\n"
+                "           [--microcode <file> | --images <dir>] [--cycles <n>] [--at <addr>] [--table <file>]\n"
+                "           [--check]\n", pgm);
+        return EXIT_FAILURE;
+    }
+
+
+    // -- the images, the program, and a copy of it in every lane
+    SimRom rom;
+    Predecoded pd;
+    uint8_t *image = LoadSimRom(&rom, sw.microcode, sw.images);
+    uint16_t *pristine = (uint16_t *)calloc(MEMORY_WORDS, sizeof(uint16_t));
+    LaneWords *mem = (LaneWords *)aligned_alloc(sizeof(LaneWords), MEMORY_WORDS * sizeof(LaneWords));
+
+    if (!image || !pristine || !mem || !LoadProgram(sw.program, pristine, sw.at) || !Predecode(&rom, &pd)) {
+        if (image && (!pristine || !mem)) fprintf(stderr, "Out of memory\n");
+        free(image);
+        free(pristine);
+        free(mem);
+        return EXIT_FAILURE;
+    }
+
+    for (int a = 0; a < MEMORY_WORDS; a ++) {
+        for (int l = 0; l < SIMD_LANES; l ++) mem[a][l] = pristine[a];
+    }
+
+
+    // -- and the runs, with the table through a memory stream
+    char *text = NULL;
+    size_t len = 0;
+    FILE *table = sw.table ? open_memstream(&text, &len) : NULL;
+    bool ok = (!sw.table || table) && RunSweep(&sw, &pd, pristine, mem, table);
+
+    if (table) {
+        fclose(table);
+        ok = ok && WriteFileAtomic(sw.table, (const uint8_t *)text, len);
+        free(text);
+    }
+
+    FreePredecoded(&pd);
+    free(image);
+    free(pristine);
+    free(mem);
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,264 @@
+//===================================================================================================================
+//  microcode-file.cc -- Load the microcode from a text description
+//
+//  This lets the microcode be changed without recompiling `eeprom`.  Each line of the file describes one
+//  instruction:
+//
+//      <instruction>  <depends on>  <imm16>  <not met>  <signals when met>
+//
+//  Where:
+//  - <instruction> is the name from opcodes.h without the `OPCODE_` (or a number, such as 0x01f)
+//  - <depends on> is `-` or the flags the instruction depends on, without the `FLAG_`, joined with `|`
+//  - <imm16> is `imm` when an imm16 word follows the instruction, or `-` when there is none
+//  - <not met> is `nop`, or `skip` to do nothing but also skip over the imm16
+//  - <signals when met> are the names of the signals from control.h, joined with `|`
+//
+//  Anything from a `#` to the end of the line is a comment.  Instructions which are not described behave as a NOP.
+//
+//  -----------------------------------------------------------------------------------------------------------------
+//
+//     Date      Tracker  Version  Pgmr  Description
+//  -----------  -------  -------  ----  ---------------------------------------------------------------------------
+//  2026-Oct-16  Initial  v0.0.1   ADCL  Initial version
+//
+//===================================================================================================================
+
+
+#include <cstdint>
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <ctype.h>
+#include <errno.h>
+
+#include "eeprom.h"
+
+
+
+//
+// -- the longest line we will accept
+//    -------------------------------
+const int MAX_LINE = 1024;
+
+
+
+//
+// -- Pull the next whitespace-delimited field off the line; NULL if there is none
+//    ----------------------------------------------------------------------------
+static char *NextField(char **line)
+{
+    char *p = *line;
+
+    while (*p && isspace((unsigned char)*p)) p ++;
+    if (!*p) return NULL;
+
+    char *field = p;
+
+    while (*p && !isspace((unsigned char)*p)) p ++;
+    if (*p) *p ++ = '\0';
+
+    *line = p;
+    return field;
+}
+
+
+
+//
+// -- Parse the flags an instruction depends on
+//    -----------------------------------------
+static bool ParseFlags(const char *text, int *flags)
+{
+    *flags = FLAG_NONE;
+
+    if (strcmp(text, "-") == 0) return true;
+
+    while (*text) {
+        const char *end = strchr(text, '|');
+        size_t len = end ? (size_t)(end - text) : strlen(text);
+        int i;
+
+        for (i = 0; i < FLAG_NAME_COUNT; i ++) {
+            if (strlen(flagNames[i].name) == len && strncmp(flagNames[i].name, text, len) == 0) break;
+        }
+
+        if (i == FLAG_NAME_COUNT) return false;
+
+        *flags |= flagNames[i].flag;
+        text += len + (end ? 1 : 0);
+    }
+
+    return true;
+}
+
+
+
+//
+// -- Parse the signals, reporting the first one we do not know
+//    ---------------------------------------------------------
+static bool ParseSignals(const char *path, int lineNo, char *text, uint128_t *signals)
+{
+    bool any = false;
+
+    *signals = 0;
+
+    while (true) {
+        while (*text && isspace((unsigned char)*text)) text ++;
+
+        char *end = text;
+        while (*end && *end != '|' && !isspace((unsigned char)*end)) end ++;
+
+        if (end == text) {
+            fprintf(stderr, "%s:%d: expected a signal name\n", path, lineNo);
+            return false;
+        }
+
+        const SignalName *sig = FindSignal(text, end - text);
+
+        if (!sig) {
+            fprintf(stderr, "%s:%d: unknown signal `%.*s`\n", path, lineNo, (int)(end - text), text);
+            return false;
+        }
+
+        *signals |= sig->value;
+        any = true;
+
+        while (*end && isspace((unsigned char)*end)) end ++;
+
+        if (!*end) return any;
+
+        if (*end != '|') {
+            fprintf(stderr, "%s:%d: expected `|` between signals\n", path, lineNo);
+            return false;
+        }
+
+        text = end + 1;
+    }
+}
+
+
+
+//
+// -- Load the microcode
+//    ------------------
+bool LoadMicrocode(const char *path, OpcodeTable *table)
+{
+    static bool defined[INSTR_COUNT];
+    char line[MAX_LINE];
+    int lineNo = 0;
+    bool ok = true;
+
+    FILE *fp = fopen(path, "r");
+
+    if (!fp) {
+        fprintf(stderr, "Unable to open %s: %s\n", path, strerror(errno));
+        return false;
+    }
+
+    for (int i = 0; i < INSTR_COUNT; i ++) {
+        table->desc[i].met = NOP_SIGNALS;
+        table->desc[i].notMet = NOP_SIGNALS;
+        table->desc[i].flags = FLAG_NONE;
+        table->desc[i].immediate = false;
+        defined[i] = false;
+    }
+
+    table->activeLow = ACTIVE_LOW;
+
+    while (fgets(line, sizeof(line), fp)) {
+        lineNo ++;
+
+        if (!strchr(line, '\n') && !feof(fp)) {
+            fprintf(stderr, "%s:%d: line is too long\n", path, lineNo);
+            ok = false;
+            break;
+        }
+
+        char *hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+
+        char *rest = line;
+        char *name = NextField(&rest);
+
+        if (!name) continue;
+
+        char *depends = NextField(&rest);
+        char *imm = NextField(&rest);
+        char *notMet = NextField(&rest);
+
+        if (!notMet) {
+            fprintf(stderr, "%s:%d: expected <instruction> <depends on> <imm16> <not met> <signals>\n", path, lineNo);
+            ok = false;
+            continue;
+        }
+
+
+        // -- the instruction, by name or by number
+        char *end;
+        int opcode = FindOpcode(name);
+
+        if (opcode < 0 && isdigit((unsigned char)*name)) {
+            opcode = strtol(name, &end, 0);
+            if (*end) opcode = -1;
+        }
+
+        if (opcode < 0 || opcode >= INSTR_COUNT) {
+            fprintf(stderr, "%s:%d: unknown instruction `%s`\n", path, lineNo, name);
+            ok = false;
+            continue;
+        }
+
+        if (defined[opcode]) {
+            fprintf(stderr, "%s:%d: instruction `%s` is described more than once\n", path, lineNo, name);
+            ok = false;
+            continue;
+        }
+
+
+        // -- the rest of the description
+        int flags;
+        uint128_t met;
+
+        if (!ParseFlags(depends, &flags)) {
+            fprintf(stderr, "%s:%d: unknown flags `%s`\n", path, lineNo, depends);
+            ok = false;
+            continue;
+        }
+
+        if (strcmp(imm, "imm") != 0 && strcmp(imm, "-") != 0) {
+            fprintf(stderr, "%s:%d: expected `imm` or `-`, not `%s`\n", path, lineNo, imm);
+            ok = false;
+            continue;
+        }
+
+        if (strcmp(notMet, "nop") != 0 && strcmp(notMet, "skip") != 0) {
+            fprintf(stderr, "%s:%d: expected `nop` or `skip`, not `%s`\n", path, lineNo, notMet);
+            ok = false;
+            continue;
+        }
+
+        bool immediate = strcmp(imm, "imm") == 0;
+        bool skip = strcmp(notMet, "skip") == 0;
+
+        if (immediate != skip) {
+            fprintf(stderr, "%s:%d: an instruction %s\n", path, lineNo,
+                    immediate ? "with an imm16 must `skip` it when not met" : "without an imm16 has nothing to `skip`");
+            ok = false;
+            continue;
+        }
+
+        if (!ParseSignals(path, lineNo, rest, &met)) {
+            ok = false;
+            continue;
+        }
+
+        table->desc[opcode].met = met;
+        table->desc[opcode].notMet = NOP_SIGNALS | (skip ? INSTRUCTION_SUPPRESS : INSTRUCTION_ASSERT);
+        table->desc[opcode].flags = flags & FLAG_ALL;
+        table->desc[opcode].immediate = immediate;
+        defined[opcode] = true;
+    }
+
+    fclose(fp);
+
+    return ok;
+}
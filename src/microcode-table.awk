@@ -0,0 +1,64 @@
+##===================================================================================================================
+##  microcode-table.awk -- Turn microcode.txt into the compiled-in microcode table, microcode-table.h
+##
+##  tup runs this whenever microcode.txt changes, so the text file is the only copy of the microcode and the
+##  compiled-in image can never fall behind it.  Each line becomes one entry of `microcode[]` in microcode.h.
+##  Only the layout of each line is checked here.  An unknown signal, flag or instruction name fails the compile,
+##  and the static_asserts after `microcode[]` reject an instruction number out of range, an instruction described
+##  twice, or a flag bit the EEPROM does not see (`eeprom --microcode` reports all of these by line).  See
+##  microcode-file.cc for the format.
+##
+##  -----------------------------------------------------------------------------------------------------------------
+##
+##     Date      Tracker  Version  Pgmr  Description
+##  -----------  -------  -------  ----  ---------------------------------------------------------------------------
+##  2026-Oct-16  Initial  v0.0.1   ADCL  Initial version
+##
+##===================================================================================================================
+
+
+function fail(why)
+{
+    print FILENAME ":" FNR ": " why > "/dev/stderr"
+    exit 1
+}
+
+
+BEGIN {
+    print "// -- generated from microcode.txt by microcode-table.awk; do not edit"
+}
+
+
+{
+    sub(/#.*/, "")
+    if (NF == 0) next
+    if (NF < 5) fail("expected <instruction> <depends on> <imm16> <not met> <signals>")
+
+
+    # -- the instruction, by name or by number
+    opcode = ($1 ~ /^[0-9]/) ? $1 : "OPCODE_" $1
+
+
+    # -- the flags it depends on
+    if ($2 == "-") {
+        flags = "FLAG_NONE"
+    } else {
+        flags = "FLAG_" $2
+        gsub(/\|/, " | FLAG_", flags)
+    }
+
+
+    # -- the imm16, which must be skipped when the condition is not met
+    if ($3 != "imm" && $3 != "-") fail("expected `imm` or `-`, not `" $3 "`")
+    if ($4 != "nop" && $4 != "skip") fail("expected `nop` or `skip`, not `" $4 "`")
+    if (($3 == "imm") != ($4 == "skip")) fail("an imm16 must be skipped when not met, and only an imm16")
+
+
+    # -- and the signals, which are the rest of the line
+    signals = $0
+    sub(/^[ \t]*[^ \t]+[ \t]+[^ \t]+[ \t]+[^ \t]+[ \t]+[^ \t]+[ \t]+/, "", signals)
+    sub(/[ \t]+$/, "", signals)
+    gsub(/[ \t]*\|[ \t]*/, " | ", signals)
+
+    print "    { " opcode ", " flags ", " ($3 == "imm" ? "true" : "false") ", " signals " },"
+}
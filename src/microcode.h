@@ -0,0 +1,172 @@
+//===================================================================================================================
+//  microcode.h -- The microcode for each instruction and the functions to expand it into an EEPROM image
+//
+//  Everything in here is constexpr so it can be used to build the image at compile time (see rom-image.h) or
+//  at runtime for other part sizes.
+//
+//  -----------------------------------------------------------------------------------------------------------------
+//
+//     Date      Tracker  Version  Pgmr  Description
+//  -----------  -------  -------  ----  ---------------------------------------------------------------------------
+//  2026-Oct-16  Initial  v0.0.1   ADCL  Initial version (split from control.cc)
+//  2026-Oct-16  Initial  v0.0.2   ADCL  Split the expansion out so it can run over any slice of any part size
+//  2026-Oct-16  Initial  v0.0.3   ADCL  Expand straight into the EEPROM lanes; no more 128-bit word per address
+//  2026-Oct-16  Initial  v0.0.4   ADCL  The table is generated from microcode.txt and checked at compile time
+//  2026-Oct-16  Initial  v0.0.5   ADCL  Invert the active-low bits
+//
+//===================================================================================================================
+
+
+#pragma once
+
+
+#include "control.h"
+
+
+//
+// -- These are the instructions which will be encoded
+//
+//    Recall that the instruction word has the following format:
+//
+//              CCCC IIII IIII IIII
+//
+//    Where:
+//    - CCCC are control flags, used to condition the instruction
+//    - IIII IIII IIII is the instruction, encoded in the enum below
+//    --------------------------------------------------------------
+#include "opcodes.h"
+
+
+//
+// -- This is the microcode for each instruction.  microcode.txt is the only copy: tup turns it into
+//    microcode-table.h with microcode-table.awk, so the compiled-in image is always built from the same text
+//    `eeprom --microcode` reads
+//    -------------------------------------------------------------------------------------------------------
+constexpr Microcode microcode[] = {
+#include "microcode-table.h"
+};
+
+
+//
+// -- Check the microcode the same way LoadMicrocode() does, so a mistake in microcode.txt fails the compile
+//    rather than quietly building a ROM which `eeprom --microcode` would refuse.  A number out of range, an
+//    instruction described twice, or a flag bit the EEPROM never sees is rejected.
+//    ------------------------------------------------------------------------------------------------------
+constexpr size_t MICROCODE_COUNT = sizeof(microcode) / sizeof(microcode[0]);
+
+constexpr bool MicrocodeInRange(void)
+{
+    for (size_t i = 0; i < MICROCODE_COUNT; i ++) {
+        if (microcode[i].opcode < 0 || microcode[i].opcode >= INSTR_COUNT) return false;
+    }
+
+    return true;
+}
+
+constexpr bool MicrocodeUnique(void)
+{
+    for (size_t i = 0; i < MICROCODE_COUNT; i ++) {
+        for (size_t j = i + 1; j < MICROCODE_COUNT; j ++) {
+            if (microcode[i].opcode == microcode[j].opcode) return false;
+        }
+    }
+
+    return true;
+}
+
+constexpr bool MicrocodeKnownFlags(void)
+{
+    for (size_t i = 0; i < MICROCODE_COUNT; i ++) {
+        if (microcode[i].flags & ~FLAG_ALL) return false;
+    }
+
+    return true;
+}
+
+static_assert(MicrocodeInRange(), "microcode.txt: an instruction number is out of range");
+static_assert(MicrocodeUnique(), "microcode.txt: an instruction is described more than once");
+static_assert(MicrocodeKnownFlags(), "microcode.txt: an instruction depends on a flag the EEPROM does not see");
+
+
+//
+// -- Build the decode table from the microcode
+//    -----------------------------------------
+constexpr OpcodeTable BuildOpcodeTable(void)
+{
+    OpcodeTable table {};
+
+    for (int i = 0; i < INSTR_COUNT; i ++) {
+        table.desc[i].met = NOP_SIGNALS;
+        table.desc[i].notMet = NOP_SIGNALS;
+        table.desc[i].flags = FLAG_NONE;
+        table.desc[i].immediate = false;
+    }
+
+    table.activeLow = ACTIVE_LOW;
+
+    for (size_t i = 0; i < MICROCODE_COUNT; i ++) {
+        OpcodeDesc &desc = table.desc[microcode[i].opcode];
+
+        desc.met = microcode[i].met;
+        desc.notMet = NOP_SIGNALS | (microcode[i].immediate ? INSTRUCTION_SUPPRESS : INSTRUCTION_ASSERT);
+        desc.flags = microcode[i].flags;
+        desc.immediate = microcode[i].immediate;
+    }
+
+    return table;
+}
+
+
+inline constexpr OpcodeTable opcodeTable = BuildOpcodeTable();
+
+
+//
+// -- Break the prom location down to the flags and instruction portions
+//    and determine the control lines for each possible combination
+//    ------------------------------------------------------------------
+constexpr uint128_t GenerateControlSignals(int loc)
+{
+    int flags = (loc >> 12) & 0x7;           // top 3 bits of the memory address; flags for augmenting the control signals
+    int instr = (loc >>  0) & 0xfff;         // bottom 12 bits for the memory address of the instruction
+
+    return OpcodeSignals(opcodeTable.desc[instr], flags);
+}
+
+
+//
+// -- Expand the instructions [first, last) into an image of `size` bytes.  For each combination of the flags an
+//    instruction depends on, the control word and its EEPROM bytes are worked out once and then broadcast into
+//    every flags bank which shares that combination.  Parts larger than PROM_SIZE have more address lines than
+//    we use today, so their extra banks are mirrors of the first 8.
+//
+//    Only the instruction slice [first, last) of each bank is written, so separate slices can be expanded at
+//    the same time.  The active-low bits are inverted on the way.
+//    ----------------------------------------------------------------------------------------------------------
+constexpr void ExpandInstructions(const OpcodeTable &table, uint8_t *const lanes[CTRL_LANES], int size, int first,
+        int last)
+{
+    for (int instr = first; instr < last; instr ++) {
+        const OpcodeDesc &desc = table.desc[instr];
+        int cls = 0;
+
+        // -- walk the submasks of desc.flags; this always visits 0 and then stops when it wraps back to 0
+        do {
+            uint128_t word = OpcodeSignals(desc, cls) ^ table.activeLow;
+            uint8_t bytes[CTRL_LANES] = {};
+
+            for (int l = 0; l < CTRL_LANES; l ++) bytes[l] = (word >> (l * 8)) & 0xff;
+
+            for (int bank = 0; bank < size / INSTR_COUNT; bank ++) {
+                if ((bank & desc.flags) != cls) continue;
+
+                int loc = (bank * INSTR_COUNT) | instr;
+
+                for (int l = 0; l < CTRL_LANES; l ++) lanes[l][loc] = bytes[l];
+            }
+
+            cls = (cls - desc.flags) & desc.flags;
+        } while (cls != 0);
+    }
+}
+
+
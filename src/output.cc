@@ -0,0 +1,291 @@
+//===================================================================================================================
+//  output.cc -- Write the EEPROM images to disk
+//
+//  Each image is written with a single write() of the whole lane into a temporary file, which is then renamed
+//  over the real file.  `tup` (or anything else watching) will only ever see a complete image or the old one.
+//
+//  When an image is generated at runtime it can also be mapped: the temporary files are sized and mmap()ed, the
+//  generator writes its lanes straight into the page cache and the files are renamed into place afterwards.
+//
+//  -----------------------------------------------------------------------------------------------------------------
+//
+//     Date      Tracker  Version  Pgmr  Description
+//  -----------  -------  -------  ----  ---------------------------------------------------------------------------
+//  2026-Oct-16  Initial  v0.0.1   ADCL  Initial version (replaces the per-byte fwrite() calls in control.cc)
+//  2026-Oct-16  Initial  v0.0.2   ADCL  Add the memory-mapped backend and the output directory
+//  2026-Oct-16  Initial  v0.0.3   ADCL  Add the paths of the other files written for each lane
+//  2026-Oct-16  Initial  v0.0.4   ADCL  Add ReadImage() (from package.cc)
+//
+//===================================================================================================================
+
+
+#include <cstdint>
+#include <stdio.h>
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "eeprom.h"
+
+
+
+//
+// -- The names of the output files, one for each EEPROM
+//    --------------------------------------------------
+const char *laneFile[CTRL_LANES] = {
+    "ctrl1.bin", "ctrl2.bin", "ctrl3.bin", "ctrl4.bin", "ctrl5.bin", "ctrl6.bin",
+    "ctrl7.bin", "ctrl8.bin", "ctrl9.bin", "ctrla.bin", "ctrlb.bin", "ctrlc.bin",
+};
+
+
+
+//
+// -- Build the path to the image for a lane
+//    --------------------------------------
+void LanePath(char *path, size_t len, const char *dir, int lane)
+{
+    if (dir && *dir) snprintf(path, len, "%s/%s", dir, laneFile[lane]);
+    else snprintf(path, len, "%s", laneFile[lane]);
+}
+
+
+
+//
+// -- Build the path to another file for a lane: the image name with its `.bin` replaced by `ext`
+//    -------------------------------------------------------------------------------------------
+void LaneSidePath(char *path, size_t len, const char *dir, int lane, const char *ext)
+{
+    int base = strlen(laneFile[lane]) - 4;
+
+    if (dir && *dir) snprintf(path, len, "%s/%.*s%s", dir, base, laneFile[lane], ext);
+    else snprintf(path, len, "%.*s%s", base, laneFile[lane], ext);
+}
+
+
+
+//
+// -- Build the path to the temporary image for a lane
+//    ------------------------------------------------
+static void LaneTempPath(char *path, size_t len, const char *dir, int lane)
+{
+    if (dir && *dir) snprintf(path, len, "%s/%s.tmp", dir, laneFile[lane]);
+    else snprintf(path, len, "%s.tmp", laneFile[lane]);
+}
+
+
+
+//
+// -- Write a whole buffer to a file descriptor, picking up after any short write
+//    ---------------------------------------------------------------------------
+static bool WriteAll(int fd, const uint8_t *data, size_t size)
+{
+    while (size) {
+        ssize_t rv = write(fd, data, size);
+
+        if (rv < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+
+        data += rv;
+        size -= rv;
+    }
+
+    return true;
+}
+
+
+
+//
+// -- Write a file through a temporary and rename it into place
+//    ---------------------------------------------------------
+bool WriteFileAtomic(const char *name, const uint8_t *data, size_t size)
+{
+    char tmp[FILENAME_MAX];
+
+    snprintf(tmp, sizeof(tmp), "%s.tmp", name);
+
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if (fd < 0) {
+        fprintf(stderr, "Unable to create %s: %s\n", tmp, strerror(errno));
+        return false;
+    }
+
+    if (!WriteAll(fd, data, size)) {
+        fprintf(stderr, "Unable to write %s: %s\n", tmp, strerror(errno));
+        close(fd);
+        unlink(tmp);
+        return false;
+    }
+
+    if (close(fd) != 0) {
+        fprintf(stderr, "Unable to close %s: %s\n", tmp, strerror(errno));
+        unlink(tmp);
+        return false;
+    }
+
+    if (rename(tmp, name) != 0) {
+        fprintf(stderr, "Unable to rename %s to %s: %s\n", tmp, name, strerror(errno));
+        unlink(tmp);
+        return false;
+    }
+
+    return true;
+}
+
+
+
+//
+// -- Write each EEPROM image
+//    -----------------------
+bool WriteImages(const char *dir, const uint8_t *const lanes[CTRL_LANES], int size)
+{
+    char path[FILENAME_MAX];
+
+    for (int l = 0; l < CTRL_LANES; l ++) {
+        LanePath(path, sizeof(path), dir, l);
+        if (!WriteFileAtomic(path, lanes[l], size)) return false;
+    }
+
+    return true;
+}
+
+
+
+//
+// -- Read the image for a lane, which must be the size of the part
+//    -------------------------------------------------------------
+bool ReadImage(const char *dir, int lane, uint8_t *data, int size)
+{
+    char path[FILENAME_MAX];
+    struct stat st;
+
+    LanePath(path, sizeof(path), dir, lane);
+
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size != size || read(fd, data, size) != size) {
+        fprintf(stderr, "Unable to read %s: %s\n", path, fd < 0 ? strerror(errno) : "not the size of the part");
+        if (fd >= 0) close(fd);
+        return false;
+    }
+
+    close(fd);
+
+    return true;
+}
+
+
+
+//
+// -- Throw away whatever has been mapped so far, removing the temporary files
+//    ------------------------------------------------------------------------
+void AbandonImages(MappedImages *map)
+{
+    char tmp[FILENAME_MAX];
+
+    for (int l = 0; l < CTRL_LANES; l ++) {
+        if (map->lanes[l]) munmap(map->lanes[l], map->size);
+        if (map->fd[l] >= 0) {
+            close(map->fd[l]);
+
+            LaneTempPath(tmp, sizeof(tmp), map->dir, l);
+            unlink(tmp);
+        }
+
+        map->lanes[l] = NULL;
+        map->fd[l] = -1;
+    }
+}
+
+
+
+//
+// -- Create and map the temporary file for each lane
+//    -----------------------------------------------
+bool MapImages(MappedImages *map, const char *dir, int size)
+{
+    char tmp[FILENAME_MAX];
+
+    map->dir = dir;
+    map->size = size;
+
+    for (int l = 0; l < CTRL_LANES; l ++) {
+        map->lanes[l] = NULL;
+        map->fd[l] = -1;
+    }
+
+    for (int l = 0; l < CTRL_LANES; l ++) {
+        LaneTempPath(tmp, sizeof(tmp), dir, l);
+
+        map->fd[l] = open(tmp, O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+        if (map->fd[l] < 0) {
+            fprintf(stderr, "Unable to create %s: %s\n", tmp, strerror(errno));
+            AbandonImages(map);
+            return false;
+        }
+
+        if (ftruncate(map->fd[l], size) != 0) {
+            fprintf(stderr, "Unable to size %s: %s\n", tmp, strerror(errno));
+            AbandonImages(map);
+            return false;
+        }
+
+        void *addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, map->fd[l], 0);
+
+        if (addr == MAP_FAILED) {
+            fprintf(stderr, "Unable to map %s: %s\n", tmp, strerror(errno));
+            AbandonImages(map);
+            return false;
+        }
+
+        map->lanes[l] = (uint8_t *)addr;
+    }
+
+    return true;
+}
+
+
+
+//
+// -- Unmap the images and rename them into place
+//    -------------------------------------------
+bool CommitImages(MappedImages *map)
+{
+    char path[FILENAME_MAX];
+    char tmp[FILENAME_MAX];
+
+    for (int l = 0; l < CTRL_LANES; l ++) {
+        if (munmap(map->lanes[l], map->size) != 0) {
+            LaneTempPath(tmp, sizeof(tmp), map->dir, l);
+            fprintf(stderr, "Unable to unmap %s: %s\n", tmp, strerror(errno));
+            map->lanes[l] = NULL;
+            AbandonImages(map);
+            return false;
+        }
+
+        map->lanes[l] = NULL;
+    }
+
+    for (int l = 0; l < CTRL_LANES; l ++) {
+        LanePath(path, sizeof(path), map->dir, l);
+        LaneTempPath(tmp, sizeof(tmp), map->dir, l);
+
+        if (close(map->fd[l]) != 0 || rename(tmp, path) != 0) {
+            fprintf(stderr, "Unable to finish %s: %s\n", path, strerror(errno));
+            map->fd[l] = -1;
+            unlink(tmp);
+            AbandonImages(map);
+            return false;
+        }
+
+        map->fd[l] = -1;
+    }
+
+    return true;
+}
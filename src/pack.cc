@@ -0,0 +1,540 @@
+//===================================================================================================================
+//  pack.cc -- Work out where each field of the control word goes so that it takes the fewest EEPROMs
+//
+//  The fields are described in a text file (see fields.txt), one field to a line:
+//
+//      <field>  <bits>  <values>
+//
+//  Where:
+//  - <field> is the name of the field, such as MAIN or PC
+//  - <bits> is its width, 1 to 8
+//  - <values> are the names of its values, from 0 up, each of which becomes the signal <field>_<value>; a value
+//    written `<name>=<number>` jumps ahead to <number>.  A one-bit field with the single value `-` is a strobe,
+//    and the signal is just <field>.
+//
+//  A line which starts with a space carries on the values of the field above.  Anything from a `#` to the end of
+//  the line is a comment.
+//
+//  A field is never split across two EEPROMs (a multi-bit field usually feeds one decoder), so this is bin
+//  packing: the fields are placed widest first, each into the first EEPROM with room for it.  Within an EEPROM
+//  the fields keep the order they were described in, from bit 7 down.  The result is checked against the fewest
+//  EEPROMs any layout could use: enough for all the bits, and one each for the fields wider than 4 bits.
+//
+//  The layout is written as the signal enum (to replace the one in control.h, and signals.cc, to match) and as a
+//  map of which line each EEPROM data pin drives.  The enum ends with the same names control.h adds for
+//  readability (NOP_SIGNALS and the like, which microcode.txt uses), made up from the packed signals.
+//
+//  -----------------------------------------------------------------------------------------------------------------
+//
+//     Date      Tracker  Version  Pgmr  Description
+//  -----------  -------  -------  ----  ---------------------------------------------------------------------------
+//  2026-Oct-16  Initial  v0.0.1   ADCL  Initial version
+//
+//===================================================================================================================
+
+
+#include <cstdint>
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <ctype.h>
+#include <errno.h>
+
+#include "eeprom.h"
+
+
+
+//
+// -- The limits on what can be described
+//    -----------------------------------
+const int MAX_FIELDS = 128;
+const int MAX_VALUES = 256;
+const int MAX_NAME = 32;
+const int MAX_LINE = 1024;
+
+
+
+//
+// -- One field: what it is called, its values and, once packed, where it goes
+//    ------------------------------------------------------------------------
+typedef struct FieldValue {
+    char name[MAX_NAME];
+    int value;
+} FieldValue;
+
+
+typedef struct Field {
+    char name[MAX_NAME];
+    int bits;
+    int count;                               // the values in `value`; -1 for a strobe
+    FieldValue value[MAX_VALUES];
+    int lane;                                // where the field was packed
+    int shift;                               // ... and the bit its lowest bit is on
+} Field;
+
+
+
+//
+// -- The names control.h adds for readability at the end of its enum, and the signals each is made of.  The packed
+//    enum must have them too, so keep this in step with control.h.
+//    -------------------------------------------------------------------------------------------------------------
+typedef struct Alias {
+    const char *name;
+    const char *signals[8];                  // ends at the first NULL
+} Alias;
+
+static const Alias aliases[] = {
+    { "FETCH_ASSERT_MAIN",  { "MAIN_FETCH", "INSTRUCTION_SUPPRESS" } },
+    { "NOP_SIGNALS",        { "ADDR_BUS_1_ASSERT_PC", "PC_INC" } },
+    { "ALU_LATCHES",        { "PGM_Z_LATCH", "PGM_C_LATCH", "PGM_N_LATCH", "PGM_V_LATCH", "PGM_L_LATCH",
+                              "ALU_INPUT_LATCH" } },
+};
+
+
+
+//
+// -- Pull the next whitespace-delimited word off the line; NULL if there is none
+//    ---------------------------------------------------------------------------
+static char *NextWord(char **line)
+{
+    char *p = *line;
+
+    while (*p && isspace((unsigned char)*p)) p ++;
+    if (!*p) return NULL;
+
+    char *word = p;
+
+    while (*p && !isspace((unsigned char)*p)) p ++;
+    if (*p) *p ++ = '\0';
+
+    *line = p;
+    return word;
+}
+
+
+
+//
+// -- Add the values on (the rest of) a line to a field
+//    -------------------------------------------------
+static bool ParseValues(const char *path, int lineNo, Field *field, char *rest)
+{
+    char *word;
+
+    while ((word = NextWord(&rest)) != NULL) {
+        if (strcmp(word, "-") == 0) {
+            if (field->bits != 1 || field->count) {
+                fprintf(stderr, "%s:%d: only a one-bit field with no other values can be a strobe\n", path, lineNo);
+                return false;
+            }
+
+            field->count = -1;
+            continue;
+        }
+
+        if (field->count < 0) {
+            fprintf(stderr, "%s:%d: a strobe has no other values\n", path, lineNo);
+            return false;
+        }
+
+        int next = field->count ? field->value[field->count - 1].value + 1 : 0;
+        char *eq = strchr(word, '=');
+
+        if (eq) {
+            char *end;
+
+            *eq = '\0';
+            next = strtol(eq + 1, &end, 0);
+
+            // -- strtol() does not take 0b
+            if (eq[1] == '0' && (eq[2] == 'b' || eq[2] == 'B')) next = strtol(eq + 3, &end, 2);
+
+            if (*end || end == eq + 1) {
+                fprintf(stderr, "%s:%d: `%s` is not a value\n", path, lineNo, eq + 1);
+                return false;
+            }
+        }
+
+        if (next < 0 || next >= (1 << field->bits)) {
+            fprintf(stderr, "%s:%d: %s_%s does not fit in %d bit(s)\n", path, lineNo, field->name, word, field->bits);
+            return false;
+        }
+
+        if (strlen(word) >= (size_t)MAX_NAME || field->count >= MAX_VALUES) {
+            fprintf(stderr, "%s:%d: too many values, or a name which is too long\n", path, lineNo);
+            return false;
+        }
+
+        strcpy(field->value[field->count].name, word);
+        field->value[field->count].value = next;
+        field->count ++;
+    }
+
+    return true;
+}
+
+
+
+//
+// -- Load the fields; problems are reported against the file and line
+//    ----------------------------------------------------------------
+static bool LoadFields(const char *path, Field *fields, int *count)
+{
+    char line[MAX_LINE];
+    int lineNo = 0;
+    bool ok = true;
+
+    FILE *fp = fopen(path, "r");
+
+    if (!fp) {
+        fprintf(stderr, "Unable to open %s: %s\n", path, strerror(errno));
+        return false;
+    }
+
+    *count = 0;
+
+    while (fgets(line, sizeof(line), fp)) {
+        lineNo ++;
+
+        char *hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+
+        char *rest = line;
+
+        while (*rest && isspace((unsigned char)*rest)) rest ++;
+        if (!*rest) continue;
+
+
+        // -- more values for the field above
+        if (rest != line) {
+            if (*count == 0) {
+                fprintf(stderr, "%s:%d: values with no field\n", path, lineNo);
+                ok = false;
+            } else if (!ParseValues(path, lineNo, &fields[*count - 1], rest)) {
+                ok = false;
+            }
+
+            continue;
+        }
+
+
+        // -- a new field
+        char *name = NextWord(&rest);
+        char *bits = NextWord(&rest);
+        Field *field = &fields[*count];
+
+        if (*count >= MAX_FIELDS || strlen(name) >= (size_t)MAX_NAME) {
+            fprintf(stderr, "%s:%d: too many fields, or a name which is too long\n", path, lineNo);
+            ok = false;
+            break;
+        }
+
+        memset(field, 0, sizeof(Field));
+        strcpy(field->name, name);
+        field->bits = bits ? strtol(bits, NULL, 0) : 0;
+
+        if (field->bits < 1 || field->bits > 8) {
+            fprintf(stderr, "%s:%d: expected <field> <bits (1..8)> <values>\n", path, lineNo);
+            ok = false;
+            continue;
+        }
+
+        (*count) ++;
+
+        if (!ParseValues(path, lineNo, field, rest)) ok = false;
+    }
+
+    fclose(fp);
+
+    for (int f = 0; ok && f < *count; f ++) {
+        if (fields[f].count == 0) {
+            fprintf(stderr, "%s: field %s has no values\n", path, fields[f].name);
+            ok = false;
+        }
+    }
+
+    return ok;
+}
+
+
+
+//
+// -- Pack the fields, widest first, into the first EEPROM with room; returns the number of EEPROMs used
+//    --------------------------------------------------------------------------------------------------
+static int PackFields(Field *fields, int count, int used[])
+{
+    static int order[MAX_FIELDS];
+    int lanes = 0;
+
+    for (int f = 0; f < count; f ++) order[f] = f;
+
+    // -- widest first; a stable insertion sort keeps the described order among fields of the same width
+    for (int i = 1; i < count; i ++) {
+        int f = order[i];
+        int j = i;
+
+        while (j > 0 && fields[order[j - 1]].bits < fields[f].bits) {
+            order[j] = order[j - 1];
+            j --;
+        }
+
+        order[j] = f;
+    }
+
+    for (int i = 0; i < count; i ++) {
+        Field *field = &fields[order[i]];
+        int l = 0;
+
+        while (l < lanes && used[l] + field->bits > 8) l ++;
+
+        if (l == lanes) used[lanes ++] = 0;
+
+        field->lane = l;
+        used[l] += field->bits;
+    }
+
+
+    // -- now lay out each EEPROM in the described order, from bit 7 down
+    for (int l = 0; l < lanes; l ++) {
+        int top = 8;
+
+        for (int f = 0; f < count; f ++) {
+            if (fields[f].lane != l) continue;
+
+            top -= fields[f].bits;
+            fields[f].shift = top;
+        }
+    }
+
+    return lanes;
+}
+
+
+
+//
+// -- Is `name` one of the signals the fields describe?
+//    -------------------------------------------------
+static bool HasSignal(const Field *fields, int count, const char *name)
+{
+    for (int f = 0; f < count; f ++) {
+        size_t len = strlen(fields[f].name);
+
+        if (strncmp(name, fields[f].name, len) != 0) continue;
+        if (fields[f].count < 0 && name[len] == '\0') return true;
+        if (fields[f].count < 0 || name[len] != '_') continue;
+
+        for (int v = 0; v < fields[f].count; v ++) {
+            if (strcmp(name + len + 1, fields[f].value[v].name) == 0) return true;
+        }
+    }
+
+    return false;
+}
+
+
+
+//
+// -- Check that every signal the readability names are made of is described, so the enum will compile
+//    ------------------------------------------------------------------------------------------------
+static bool CheckAliases(const char *source, const Field *fields, int count)
+{
+    bool ok = true;
+
+    for (size_t a = 0; a < sizeof(aliases) / sizeof(aliases[0]); a ++) {
+        for (int i = 0; aliases[a].signals[i]; i ++) {
+            if (HasSignal(fields, count, aliases[a].signals[i])) continue;
+
+            fprintf(stderr, "%s: there is no signal %s, which %s is made of\n", source, aliases[a].signals[i],
+                    aliases[a].name);
+            ok = false;
+        }
+    }
+
+    return ok;
+}
+
+
+
+//
+// -- Write the signal enum for the layout, in the style of control.h
+//    ---------------------------------------------------------------
+static void WriteEnum(FILE *fp, const char *source, const Field *fields, int count, int lanes)
+{
+    static const char rule[] = "//=================================================================================="
+            "=================================";
+
+    fprintf(fp, "%s\n//  The control signals, packed into %d EEPROMs by `eeprom pack %s`; do not edit\n%s\n\n\n", rule,
+            lanes, source, rule);
+    fprintf(fp, "enum : uint128_t {\n");
+
+    for (int l = 0; l < lanes; l ++) {
+        char title[16];
+
+        snprintf(title, sizeof(title), "CTRL%d", l + 1);
+
+        if (l) fprintf(fp, "\n\n    //---------------------------------------------------\n\n");
+        fprintf(fp, "    //\n    // == %s\n    //    %.*s\n", title, (int)strlen(title), "================");
+
+        for (int f = 0; f < count; f ++) {
+            const Field *field = &fields[f];
+
+            if (field->lane != l) continue;
+
+            int hi = field->shift + field->bits - 1;
+
+            if (field->bits == 1) fprintf(fp, "\n    // bit %d -- %s\n", hi, field->name);
+            else fprintf(fp, "\n    // bits %d:%d -- %s\n", hi, field->shift, field->name);
+
+            for (int v = 0; v < (field->count < 0 ? 1 : field->count); v ++) {
+                char bin[16];
+                int value = field->count < 0 ? 1 : field->value[v].value;
+
+                for (int b = 0; b < field->bits; b ++) bin[b] = '0' + ((value >> (field->bits - 1 - b)) & 1);
+                bin[field->bits] = '\0';
+
+                // -- the name, lined up the way control.h does it
+                int len = fprintf(fp, "    %s%s%s", field->name, field->count < 0 ? "" : "_",
+                        field->count < 0 ? "" : field->value[v].name);
+
+                fprintf(fp, "%*s= (((uint128_t)0b%sul)%*s<< %d) << %d,\n", len < 28 ? 28 - len : 1, "", bin,
+                        8 - field->bits, "", field->shift, l * 8);
+            }
+        }
+    }
+
+
+    // -- and the names for readability, from the packed signals
+    fprintf(fp, "\n\n    //---------------------------------------------------\n\n\n");
+    fprintf(fp, "    //\n    // == Improve code readability\n    //    ========================\n");
+
+    for (size_t a = 0; a < sizeof(aliases) / sizeof(aliases[0]); a ++) {
+        int len = fprintf(fp, "    %s", aliases[a].name);
+
+        fprintf(fp, "%*s= %s", len < 28 ? 28 - len : 1, "", aliases[a].signals[0]);
+        for (int i = 1; aliases[a].signals[i]; i ++) fprintf(fp, " | %s", aliases[a].signals[i]);
+        fprintf(fp, ",\n");
+    }
+
+    fprintf(fp, "};\n");
+}
+
+
+
+//
+// -- Write the map of which line each data pin of each EEPROM drives
+//    ---------------------------------------------------------------
+static void WriteMap(FILE *fp, const Field *fields, int count, int lanes)
+{
+    for (int l = 0; l < lanes; l ++) {
+        fprintf(fp, "%s# ctrl%x.bin\n", l ? "\n" : "", l + 1);
+
+        for (int b = 7; b >= 0; b --) {
+            int f;
+
+            for (f = 0; f < count; f ++) {
+                if (fields[f].lane == l && b >= fields[f].shift && b < fields[f].shift + fields[f].bits) break;
+            }
+
+            if (f == count) fprintf(fp, "D%d  (spare)\n", b);
+            else if (fields[f].bits == 1) fprintf(fp, "D%d  %s\n", b, fields[f].name);
+            else fprintf(fp, "D%d  %s bit %d\n", b, fields[f].name, b - fields[f].shift);
+        }
+    }
+}
+
+
+
+//
+// -- Write something through a memory stream and then into place
+//    -----------------------------------------------------------
+static bool WriteOutput(const char *path, const char *source, const Field *fields, int count, int lanes, bool header)
+{
+    char *text = NULL;
+    size_t len = 0;
+    FILE *fp = open_memstream(&text, &len);
+
+    if (!fp) {
+        fprintf(stderr, "Out of memory\n");
+        return false;
+    }
+
+    if (header) WriteEnum(fp, source, fields, count, lanes);
+    else WriteMap(fp, fields, count, lanes);
+
+    fclose(fp);
+
+    bool ok = path ? WriteFileAtomic(path, (const uint8_t *)text, len) : fwrite(text, 1, len, stdout) == len;
+
+    free(text);
+
+    return ok;
+}
+
+
+
+//
+// -- Tell the user how to run this
+//    -----------------------------
+static void Usage(const char *pgm)
+{
+    fprintf(stderr, "Usage: %s pack <fields> [--header <file>] [--map <file>]\n", pgm);
+    fprintf(stderr, "  --header <file>   write the signal enum for the packed layout to <file>\n");
+    fprintf(stderr, "  --map <file>      write which line each EEPROM data pin drives to <file> (default: print it)\n");
+}
+
+
+
+//
+// -- The `pack` subcommand
+//    ---------------------
+int Pack(const char *pgm, int argc, char *argv[])
+{
+    static Field fields[MAX_FIELDS];
+    const char *source = NULL;
+    const char *header = NULL;
+    const char *map = NULL;
+    int used[MAX_FIELDS];
+    int count;
+
+    for (int i = 0; i < argc; i ++) {
+        if (strcmp(argv[i], "--header") == 0 && i + 1 < argc) header = argv[++ i];
+        else if (strcmp(argv[i], "--map") == 0 && i + 1 < argc) map = argv[++ i];
+        else if (argv[i][0] != '-' && !source) source = argv[i];
+        else {
+            Usage(pgm);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!source) {
+        Usage(pgm);
+        return EXIT_FAILURE;
+    }
+
+    if (!LoadFields(source, fields, &count)) return EXIT_FAILURE;
+
+
+    // -- the fewest EEPROMs any layout could use
+    int bits = 0;
+    int wide = 0;
+
+    for (int f = 0; f < count; f ++) {
+        bits += fields[f].bits;
+        wide += fields[f].bits > 4;
+    }
+
+    int least = (bits + 7) / 8;
+    if (wide > least) least = wide;
+
+    int lanes = PackFields(fields, count, used);
+
+    printf("%d field(s), %d bit(s): packed into %d EEPROM(s) (%s); control.h uses %d\n", count, bits, lanes,
+            lanes == least ? "no layout can use fewer" : "a better layout may exist", CTRL_LANES);
+
+    if (lanes > CTRL_LANES) printf("Warning: the generator only drives %d EEPROMs\n", CTRL_LANES);
+
+    if (header && !CheckAliases(source, fields, count)) return EXIT_FAILURE;
+    if (header && !WriteOutput(header, source, fields, count, lanes, true)) return EXIT_FAILURE;
+    if (!WriteOutput(map, source, fields, count, lanes, false)) return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
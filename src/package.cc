@@ -0,0 +1,150 @@
+//===================================================================================================================
+//  package.cc -- Write every EEPROM image into one package, `ctrl.rom`, along with the instruction names
+//
+//  The format is described in rom-package.h.  The package is built from the images once they have been written
+//  (whichever way that happened), so it always holds exactly what is in the ctrl*.bin files.
+//
+//  -----------------------------------------------------------------------------------------------------------------
+//
+//     Date      Tracker  Version  Pgmr  Description
+//  -----------  -------  -------  ----  ---------------------------------------------------------------------------
+//  2026-Oct-16  Initial  v0.0.1   ADCL  Initial version
+//  2026-Oct-16  Initial  v0.0.2   ADCL  Read the images with ReadImage()
+//
+//===================================================================================================================
+
+
+#include <cstdint>
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+
+#include "eeprom.h"
+#include "rom-package.h"
+
+
+
+//
+// -- Round up to a multiple of `align`
+//    ---------------------------------
+static uint32_t Align(uint32_t offset, uint32_t align)
+{
+    return (offset + align - 1) / align * align;
+}
+
+
+
+//
+// -- Write the package
+//    -----------------
+bool WritePackage(const char *dir, int size, const char *source, uint128_t activeLow)
+{
+    char path[FILENAME_MAX];
+    uint32_t stringsSize = 0;
+
+    for (int o = 0; o < OPCODE_NAME_COUNT; o ++) stringsSize += strlen(opcodeNames[o].name) + 1;
+
+
+    // -- lay it out
+    uint32_t laneTable = sizeof(PackageHeader);
+    uint32_t opcodeTable = laneTable + CTRL_LANES * sizeof(PackageLane);
+    uint32_t strings = opcodeTable + OPCODE_NAME_COUNT * sizeof(PackageOpcode);
+    uint32_t images = Align(strings + stringsSize, PACKAGE_ALIGN);
+    size_t length = images + (size_t)CTRL_LANES * Align(size, PACKAGE_ALIGN);
+
+    uint8_t *pkg = (uint8_t *)calloc(length, 1);
+
+    if (!pkg) {
+        fprintf(stderr, "Out of memory\n");
+        return false;
+    }
+
+    PackageHeader *hdr = (PackageHeader *)pkg;
+    PackageLane *lanes = (PackageLane *)(pkg + laneTable);
+    PackageOpcode *opcodes = (PackageOpcode *)(pkg + opcodeTable);
+    char *names = (char *)(pkg + strings);
+
+
+    // -- the images
+    for (int l = 0; l < CTRL_LANES; l ++) {
+        uint32_t offset = images + l * Align(size, PACKAGE_ALIGN);
+
+        if (!ReadImage(dir, l, pkg + offset, size)) {
+            free(pkg);
+            return false;
+        }
+
+        strncpy(lanes[l].name, laneFile[l], sizeof(lanes[l].name) - 1);
+        lanes[l].offset = offset;
+        lanes[l].size = size;
+        lanes[l].crc = Crc32(0, pkg + offset, size);
+    }
+
+
+    // -- the instruction names
+    uint32_t name = 0;
+
+    for (int o = 0; o < OPCODE_NAME_COUNT; o ++) {
+        opcodes[o].opcode = opcodeNames[o].opcode;
+        opcodes[o].name = name;
+
+        strcpy(names + name, opcodeNames[o].name);
+        name += strlen(opcodeNames[o].name) + 1;
+    }
+
+
+    // -- and finally the header, with the CRC over all of that
+    memcpy(hdr->magic, PACKAGE_MAGIC, sizeof(PACKAGE_MAGIC));
+    hdr->version = PACKAGE_VERSION;
+    snprintf(hdr->build, sizeof(hdr->build), "eeprom %s %s", EEPROM_VERSION, source);
+    hdr->laneCount = CTRL_LANES;
+    hdr->laneSize = size;
+    hdr->laneTable = laneTable;
+    hdr->opcodeCount = OPCODE_NAME_COUNT;
+    hdr->opcodeTable = opcodeTable;
+    hdr->strings = strings;
+    hdr->stringsSize = stringsSize;
+    hdr->activeLow[0] = (uint64_t)activeLow;
+    hdr->activeLow[1] = (uint64_t)(activeLow >> 64);
+    hdr->crc = Crc32(0, pkg, images);
+
+    if (dir && *dir) snprintf(path, sizeof(path), "%s/%s", dir, PACKAGE_FILE);
+    else snprintf(path, sizeof(path), "%s", PACKAGE_FILE);
+
+    bool ok = WriteFileAtomic(path, pkg, length);
+
+    free(pkg);
+
+    return ok;
+}
+
+
+
+//
+// -- The `inspect` subcommand: check a package and say what is in it
+//    ---------------------------------------------------------------
+int Inspect(const char *pgm, int argc, char *argv[])
+{
+    RomPackage pkg;
+
+    if (argc != 1) {
+        fprintf(stderr, "Usage: %s inspect <package>\n", pgm);
+        return EXIT_FAILURE;
+    }
+
+    if (!MapPackage(argv[0], &pkg, true)) return EXIT_FAILURE;
+
+    printf("%s: %s, %u image(s) of %u byte(s), %u instruction name(s); all CRCs match\n", argv[0],
+            pkg.header->build, pkg.header->laneCount, pkg.header->laneSize, pkg.header->opcodeCount);
+
+    printf("  active low   0x%016llx%016llx\n", (unsigned long long)pkg.header->activeLow[1],
+            (unsigned long long)pkg.header->activeLow[0]);
+
+    for (uint32_t l = 0; l < pkg.header->laneCount; l ++) {
+        printf("  %-12s at 0x%08x  crc 0x%08x\n", pkg.lanes[l].name, pkg.lanes[l].offset, pkg.lanes[l].crc);
+    }
+
+    UnmapPackage(&pkg);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,157 @@
+//===================================================================================================================
+//  plan.cc -- Work out which pages of each EEPROM actually need to be programmed
+//
+//  Burning all 12 EEPROMs in full is the slowest part of changing the microcode, and most changes only touch a
+//  handful of instructions.  Before the images are replaced, the new image for each EEPROM is compared with the
+//  one already on disk (which is what is in the chip) and the changed bytes are rounded out to the page-write
+//  size of the part.  Adjacent pages are merged, and the ranges are written to `ctrlN.plan`:
+//
+//      # ctrl3.bin: 2 range(s), 3 page(s), 192 byte(s) to program (of 32768)
+//      0040-007f
+//      1040-10bf
+//
+//  Each range is inclusive, in hex.  If there is no old image (or it is the wrong size), the plan covers the
+//  whole part.
+//
+//  -----------------------------------------------------------------------------------------------------------------
+//
+//     Date      Tracker  Version  Pgmr  Description
+//  -----------  -------  -------  ----  ---------------------------------------------------------------------------
+//  2026-Oct-16  Initial  v0.0.1   ADCL  Initial version
+//  2026-Oct-16  Initial  v0.0.2   ADCL  Name the plan with LaneSidePath()
+//
+//===================================================================================================================
+
+
+#include <cstdint>
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "eeprom.h"
+
+
+
+//
+// -- Is any byte in this page different?
+//    -----------------------------------
+static bool PageChanged(const uint8_t *oldLane, const uint8_t *newLane, int page)
+{
+    return memcmp(&oldLane[page * EEPROM_PAGE_SIZE], &newLane[page * EEPROM_PAGE_SIZE], EEPROM_PAGE_SIZE) != 0;
+}
+
+
+
+//
+// -- Write the plan for one EEPROM; a NULL old lane means everything must be programmed
+//    ----------------------------------------------------------------------------------
+static bool WritePlan(const char *dir, int lane, const uint8_t *oldLane, const uint8_t *newLane, int size)
+{
+    char path[FILENAME_MAX];
+    char text[256];
+    int pages = size / EEPROM_PAGE_SIZE;
+    int ranges = 0;
+    int changed = 0;
+
+    LaneSidePath(path, sizeof(path), dir, lane, ".plan");
+
+
+    // -- count first so the summary can go at the top
+    for (int p = 0; p < pages; p ++) {
+        if (oldLane && !PageChanged(oldLane, newLane, p)) continue;
+
+        changed ++;
+        if (p == 0 || (oldLane && !PageChanged(oldLane, newLane, p - 1))) ranges ++;
+    }
+
+    FILE *fp = fopen(path, "w");
+
+    if (!fp) {
+        fprintf(stderr, "Unable to create %s: %s\n", path, strerror(errno));
+        return false;
+    }
+
+    snprintf(text, sizeof(text), "# %s: %d range(s), %d page(s), %d byte(s) to program (of %d)\n",
+            laneFile[lane], ranges, changed, changed * EEPROM_PAGE_SIZE, size);
+    fputs(text, fp);
+    fputs(text + 2, stdout);
+
+
+    // -- then write out each run of changed pages
+    for (int p = 0; p < pages; ) {
+        if (oldLane && !PageChanged(oldLane, newLane, p)) {
+            p ++;
+            continue;
+        }
+
+        int first = p;
+
+        while (p < pages && (!oldLane || PageChanged(oldLane, newLane, p))) p ++;
+
+        fprintf(fp, "%04x-%04x\n", first * EEPROM_PAGE_SIZE, p * EEPROM_PAGE_SIZE - 1);
+    }
+
+    if (fclose(fp) != 0) {
+        fprintf(stderr, "Unable to write %s: %s\n", path, strerror(errno));
+        return false;
+    }
+
+    return true;
+}
+
+
+
+//
+// -- Write the plans given the old and new images
+//    --------------------------------------------
+bool WritePlans(const char *dir, const uint8_t *const oldLanes[CTRL_LANES], const uint8_t *const newLanes[CTRL_LANES],
+        int size)
+{
+    for (int l = 0; l < CTRL_LANES; l ++) {
+        if (!WritePlan(dir, l, oldLanes ? oldLanes[l] : NULL, newLanes[l], size)) return false;
+    }
+
+    return true;
+}
+
+
+
+//
+// -- Write the plans comparing the new images with the ones on disk
+//    --------------------------------------------------------------
+bool PlanAgainstFiles(const char *dir, const uint8_t *const newLanes[CTRL_LANES], int size)
+{
+    char path[FILENAME_MAX];
+    uint8_t *old = (uint8_t *)malloc(size);
+
+    if (!old) {
+        fprintf(stderr, "Out of memory\n");
+        return false;
+    }
+
+    for (int l = 0; l < CTRL_LANES; l ++) {
+        struct stat st;
+        bool have = false;
+
+        LanePath(path, sizeof(path), dir, l);
+
+        int fd = open(path, O_RDONLY);
+
+        if (fd >= 0) {
+            have = fstat(fd, &st) == 0 && st.st_size == size && read(fd, old, size) == size;
+            close(fd);
+        }
+
+        if (!WritePlan(dir, l, have ? old : NULL, newLanes[l], size)) {
+            free(old);
+            return false;
+        }
+    }
+
+    free(old);
+    return true;
+}
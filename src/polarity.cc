@@ -0,0 +1,175 @@
+//===================================================================================================================
+//  polarity.cc -- Choose which control bits to invert so that the most bytes match an erased EEPROM
+//
+//  An erased EEPROM reads 0xff, and a byte which is already 0xff does not need to be programmed.  For each
+//  EEPROM, the byte which shows up most often is found; inverting exactly the bits which are 0 in that byte turns
+//  every copy of it into 0xff.  No other choice of inverted bits can give more 0xff bytes, since any choice only
+//  turns one byte value into 0xff.
+//
+//  Whatever bits were chosen, the images mean nothing without them, so every set of images has `ctrl.polarity`
+//  beside it: one line holding the active-low mask they were generated with, the same way ACTIVE_LOW is written.
+//
+//  -----------------------------------------------------------------------------------------------------------------
+//
+//     Date      Tracker  Version  Pgmr  Description
+//  -----------  -------  -------  ----  ---------------------------------------------------------------------------
+//  2026-Oct-16  Initial  v0.0.1   ADCL  Initial version
+//
+//===================================================================================================================
+
+
+#include <cstdint>
+#include <stdio.h>
+#include <cstring>
+#include <errno.h>
+
+#include "eeprom.h"
+
+
+
+//
+// -- Count the bytes and the whole pages in a lane which are 0xff once `invert` is applied
+//    -------------------------------------------------------------------------------------
+static void CountErased(const uint8_t *lane, int size, uint8_t invert, int *bytes, int *pages)
+{
+    *bytes = 0;
+    *pages = 0;
+
+    for (int p = 0; p < size; p += EEPROM_PAGE_SIZE) {
+        int erased = 0;
+
+        for (int i = p; i < p + EEPROM_PAGE_SIZE; i ++) erased += (uint8_t)(lane[i] ^ invert) == 0xff;
+
+        *bytes += erased;
+        *pages += erased == EEPROM_PAGE_SIZE;
+    }
+}
+
+
+
+//
+// -- Work out (and report) the best active-low bits for the images
+//    -------------------------------------------------------------
+uint128_t BestPolarity(const uint8_t *const lanes[CTRL_LANES], int size, uint128_t activeLow, bool report)
+{
+    uint128_t best = 0;
+
+    if (report) {
+        printf("EEPROM     active-low   0xff bytes  0xff pages   best active-low   0xff bytes  0xff pages\n");
+        printf("---------  ----------  -----------  ----------   ---------------  -----------  ----------\n");
+    }
+
+    for (int l = 0; l < CTRL_LANES; l ++) {
+        static int count[256];
+        uint8_t current = (activeLow >> (l * 8)) & 0xff;
+        int top = 0;
+
+        memset(count, 0, sizeof(count));
+
+        // -- count the logical values (before any inversion)
+        for (int i = 0; i < size; i ++) count[lanes[l][i] ^ current] ++;
+
+        for (int v = 1; v < 256; v ++) {
+            if (count[v] > count[top]) top = v;
+        }
+
+        uint8_t invert = ~top;
+
+        best |= (uint128_t)invert << (l * 8);
+
+        if (report) {
+            int nowBytes, nowPages, bestBytes, bestPages;
+
+            CountErased(lanes[l], size, 0, &nowBytes, &nowPages);
+            CountErased(lanes[l], size, current ^ invert, &bestBytes, &bestPages);
+
+            printf("%-9s        0x%02x  %5d/%-5d  %4d/%-4d            0x%02x  %5d/%-5d  %4d/%d\n",
+                    laneFile[l], current, nowBytes, size, nowPages, size / EEPROM_PAGE_SIZE,
+                    invert, bestBytes, size, bestPages, size / EEPROM_PAGE_SIZE);
+        }
+    }
+
+    if (report) {
+        printf("\nBest ACTIVE_LOW for control.h: 0x%016llx%016llx\n", (unsigned long long)(best >> 64),
+                (unsigned long long)best);
+    }
+
+    return best;
+}
+
+
+
+//
+// -- The path of the polarity file in `dir`
+//    --------------------------------------
+static void PolarityPath(char *path, size_t len, const char *dir)
+{
+    if (dir && *dir) snprintf(path, len, "%s/%s", dir, POLARITY_FILE);
+    else snprintf(path, len, "%s", POLARITY_FILE);
+}
+
+
+
+//
+// -- Record the active-low mask the images in `dir` were generated with.  A file which already holds it is left
+//    alone, so a run which changes nothing touches nothing.
+//    ----------------------------------------------------------------------------------------------------------
+bool WritePolarity(const char *dir, uint128_t activeLow)
+{
+    char path[FILENAME_MAX];
+    char text[40];
+    char was[40];
+
+    PolarityPath(path, sizeof(path), dir);
+
+    int len = snprintf(text, sizeof(text), "0x%016llx%016llx\n", (unsigned long long)(activeLow >> 64),
+            (unsigned long long)activeLow);
+
+    FILE *fp = fopen(path, "r");
+
+    if (fp) {
+        size_t got = fread(was, 1, sizeof(was), fp);
+        fclose(fp);
+
+        if (got == (size_t)len && memcmp(was, text, len) == 0) return true;
+    }
+
+    return WriteFileAtomic(path, (const uint8_t *)text, len);
+}
+
+
+
+//
+// -- Read back the active-low mask of the images in `dir`; false (and reported) if it is missing or damaged
+//    ------------------------------------------------------------------------------------------------------
+bool ReadPolarity(const char *dir, uint128_t *activeLow)
+{
+    char path[FILENAME_MAX];
+    char text[40];
+    unsigned long long hi, lo;
+    int used = 0;
+
+    PolarityPath(path, sizeof(path), dir);
+
+    FILE *fp = fopen(path, "r");
+
+    if (!fp) {
+        fprintf(stderr, "Unable to open %s: %s\n", path, strerror(errno));
+        return false;
+    }
+
+    bool ok = fgets(text, sizeof(text), fp) && sscanf(text, "0x%16llx%16llx\n%n", &hi, &lo, &used) == 2 &&
+            used == 35 && text[used] == '\0';
+
+    fclose(fp);
+
+    if (!ok) {
+        fprintf(stderr, "%s is damaged; expected the 32 hex digits of the active-low mask\n", path);
+        return false;
+    }
+
+    *activeLow = ((uint128_t)hi << 64) | lo;
+
+    return true;
+}
+
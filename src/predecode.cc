@@ -0,0 +1,278 @@
+//===================================================================================================================
+//  predecode.cc -- Run the simulator from control words which have been decoded once, up front
+//
+//  StepCpu() pulls the 96 bits of the control word back apart into its fields on every cycle.  There are only a
+//  few dozen distinct control words in the images, though, so here each one is decoded once into a MicroOp which
+//  says what it does in the terms the simulator works in (which register is on each bus, which are loaded, what
+//  the counters and the adder do).  The table from instruction to MicroOp is instruction-major, so both versions
+//  of an instruction (condition met and not met) share a cache line.
+//
+//  The run loop dispatches each cycle with a computed goto.  Most cycles are a plain fetch (NOP_SIGNALS) or a step
+//  over an immediate, so those have handlers of their own; everything else goes through the general handler,
+//  which only does the parts of the cycle its MicroOp asks for.
+//
+//  -----------------------------------------------------------------------------------------------------------------
+//
+//     Date      Tracker  Version  Pgmr  Description
+//  -----------  -------  -------  ----  ---------------------------------------------------------------------------
+//  2026-Oct-16  Initial  v0.0.1   ADCL  Initial version
+//
+//===================================================================================================================
+
+
+#include <cstdint>
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <cstddef>
+
+#include "sim.h"
+#include "microcode.h"
+
+
+
+//
+// -- Decode one control word
+//    -----------------------
+MicroOp DecodeWord(uint128_t w)
+{
+    MicroOp op;
+
+    memset(&op, 0, sizeof(op));
+
+    if (w == NOP_SIGNALS) op.kind = MICRO_NOP;
+    else if (w == (NOP_SIGNALS | INSTRUCTION_SUPPRESS)) op.kind = MICRO_SKIP;
+    else op.kind = MICRO_GENERAL;
+
+
+    // -- address bus 1
+    static const uint8_t addrReg[4] = { CPU_AT(pc), CPU_AT(ra), CPU_AT(intPc), CPU_AT(intRa) };
+
+    op.addr = addrReg[(int)((w & ADDR_BUS_1_MASK) >> ADDR_BUS_1_SHIFT)];
+
+
+    // -- the main bus; anything which is not wired reads as R0, which is always 0
+    int src = (int)((w & MAIN_MASK) >> MAIN_SHIFT);
+
+    if (src >= (int)MAIN_R1 && src <= (int)MAIN_R12) op.src = CPU_REG(src);
+    else if (src >= (int)MAIN_DEV1 && src <= (int)MAIN_DEV10) op.src = CPU_DEV(src - (int)MAIN_DEV1 + 1);
+    else if (src >= (int)MAIN_CTL1 && src <= (int)MAIN_CTL10) op.src = CPU_CTL(src - (int)MAIN_CTL1 + 1);
+    else switch (src) {
+    case (int)MAIN_SP:          op.src = CPU_AT(sp);        break;
+    case (int)MAIN_RA:          op.src = CPU_AT(ra);        break;
+    case (int)MAIN_PC:          op.src = CPU_AT(pc);        break;
+    case (int)MAIN_ISP:         op.src = CPU_AT(intSp);     break;
+    case (int)MAIN_IRA:         op.src = CPU_AT(intRa);     break;
+    case (int)MAIN_IPC:         op.src = CPU_AT(intPc);     break;
+    case (int)MAIN_FETCH:       op.src = SRC_FETCH;         break;
+    case (int)MAIN_MEMORY:      op.src = SRC_FETCH;         break;
+    case (int)MAIN_ALU_ADDER:   op.src = SRC_ALU;           break;
+    default:                    op.src = CPU_REG(0);        break;
+    }
+
+
+    // -- the adder
+    int a = (int)((w & ALUA_MASK) >> ALUA_SHIFT);
+    int b = (int)((w & ALUB_MASK) >> ALUB_SHIFT);
+
+    op.aluA = (a >= 1 && a <= 12) ? CPU_REG(a) : a == 13 ? CPU_AT(sp) : a == 14 ? CPU_AT(intSp) : CPU_REG(0);
+    op.aluB = (b >= 1 && b <= 12) ? CPU_REG(b) : (b == 13 || b == 14) ? SRC_FETCH : CPU_REG(0);
+    op.carry = (int)((w & CARRY_MASK) >> CARRY_SHIFT);
+
+    static const uint128_t pgmLatch[] = { PGM_Z_LATCH, PGM_C_LATCH, PGM_N_LATCH, PGM_V_LATCH, PGM_L_LATCH };
+    static const uint128_t intLatch[] = { INT_Z_LATCH, INT_C_LATCH, INT_N_LATCH, INT_V_LATCH, INT_L_LATCH };
+
+    for (int f = 0; f < 5; f ++) {
+        if (w & pgmLatch[f]) op.pgmLatch |= 1 << f;
+        if (w & intLatch[f]) op.intLatch |= 1 << f;
+    }
+
+
+    // -- the loads and counters
+    for (int r = 1; r < REGISTERS; r ++) {
+        if (w & registerLoad[r]) op.regLoad |= 1 << r;
+    }
+
+    for (int d = 1; d <= DEVICES; d ++) {
+        if (w & deviceLoad[d]) op.devLoad |= 1 << d;
+        if (w & controlLoad[d]) op.ctlLoad |= 1 << d;
+    }
+
+    op.pcOp = (int)((w & PC_DEC) >> PC_SHIFT);
+    op.counters = (int)((w & RA_DEC) >> RA_SHIFT) | ((int)((w & SP_DEC) >> SP_SHIFT) << 2) |
+            ((int)((w & INT_PC_DEC) >> INT_PC_SHIFT) << 4) | ((int)((w & INT_RA_DEC) >> INT_RA_SHIFT) << 6) |
+            ((int)((w & INT_SP_DEC) >> INT_SP_SHIFT) << 8);
+
+
+    // -- and the rest
+    if (w & MEMORY_WRITE) op.misc |= MICRO_WRITE;
+    if (w & INSTRUCTION_SUPPRESS) op.misc |= MICRO_SUPPRESS;
+    if (w & CLC) op.misc |= MICRO_CLC;
+    if (w & STC) op.misc |= MICRO_STC;
+    if (op.src == SRC_ALU || op.pgmLatch || op.intLatch) op.misc |= MICRO_ALU;
+
+    return op;
+}
+
+
+
+//
+// -- Predecode every control word in the images, keeping one MicroOp for each distinct word
+//    --------------------------------------------------------------------------------------
+bool Predecode(const SimRom *rom, Predecoded *pd)
+{
+    const int SLOTS = INSTR_COUNT * 4;       // open addressing, never more than half full
+    uint128_t *word = (uint128_t *)malloc(SLOTS * sizeof(uint128_t));
+    int *slot = (int *)malloc(SLOTS * sizeof(int));
+
+    memset(pd, 0, sizeof(Predecoded));
+    pd->op = (MicroOp *)malloc(INSTR_COUNT * 2 * sizeof(MicroOp));
+
+    if (!word || !slot || !pd->op) {
+        fprintf(stderr, "Out of memory\n");
+        free(word);
+        free(slot);
+        free(pd->op);
+        pd->op = NULL;
+        return false;
+    }
+
+    for (int s = 0; s < SLOTS; s ++) slot[s] = -1;
+
+    for (int i = 0; i < INSTR_COUNT; i ++) {
+        for (int notMet = 0; notMet < 2; notMet ++) {
+            uint128_t w = RomWord(rom, ((notMet ? FLAG_CONDITION : 0) << 12) | i);
+            uint64_t h = ((uint64_t)w ^ (uint64_t)(w >> 64)) * 0x9e3779b97f4a7c15ull;
+            int s = h >> 50;
+
+            while (slot[s] >= 0 && word[slot[s]] != w) s = (s + 1) & (SLOTS - 1);
+
+            if (slot[s] < 0) {
+                slot[s] = pd->count;
+                word[pd->count] = w;
+                pd->op[pd->count ++] = DecodeWord(w);
+            }
+
+            pd->index[i][notMet] = slot[s];
+        }
+    }
+
+    for (int c = 0; c < 16; c ++) {
+        for (int f = 0; f < 32; f ++) {
+            if (ConditionMet(c, f)) pd->met[c] |= 1u << f;
+        }
+    }
+
+    free(word);
+    free(slot);
+
+    return true;
+}
+
+
+void FreePredecoded(Predecoded *pd)
+{
+    free(pd->op);
+    pd->op = NULL;
+}
+
+
+
+//
+// -- Run until the machine halts or `limit` cycles have gone by
+//    ----------------------------------------------------------
+uint64_t RunPredecoded(Cpu *cpu, const Predecoded *pd, uint64_t limit)
+{
+    static void *const handler[] = { &&nop, &&skip, &&general };
+    uint16_t *mem = cpu->mem;
+    uint64_t left = limit;
+    const MicroOp *op;
+
+#define DISPATCH()                                                                                                  \
+    do {                                                                                                            \
+        if (left == 0) goto done;                                                                                   \
+        left --;                                                                                                    \
+        op = CurrentOp(pd, cpu);                                                                                    \
+        goto *handler[op->kind];                                                                                    \
+    } while (0)
+
+    if (cpu->halted) return 0;
+
+    DISPATCH();
+
+
+nop:
+    cpu->irAddr = cpu->pc;
+    cpu->ir = mem[cpu->pc ++];
+    DISPATCH();
+
+
+skip:
+    cpu->pc ++;
+    cpu->ir = OPCODE_NOP;
+    DISPATCH();
+
+
+general:
+    {
+        uint16_t addr = CPU_WORD(cpu, op->addr);
+        uint16_t fetch = mem[addr];
+        uint16_t sum = 0;
+        uint8_t aluFlags = 0;
+
+        if (op->misc & MICRO_ALU) {
+            uint16_t b = op->aluB == SRC_FETCH ? fetch : CPU_WORD(cpu, op->aluB);
+            int c = (cpu->pgmFlags & CPU_C) ? 1 : 0;
+            int carry = op->carry == 0 ? 0 : op->carry == 1 ? c : op->carry == 2 ? !c : 1;
+
+            sum = Adder(CPU_WORD(cpu, op->aluA), b, carry, &aluFlags);
+        }
+
+        uint16_t bus = op->src == SRC_FETCH ? fetch : op->src == SRC_ALU ? sum : CPU_WORD(cpu, op->src);
+
+        for (unsigned m = op->regLoad; m; m &= m - 1) cpu->r[__builtin_ctz(m)] = bus;
+        for (unsigned m = op->devLoad; m; m &= m - 1) cpu->dev[__builtin_ctz(m)] = bus;
+        for (unsigned m = op->ctlLoad; m; m &= m - 1) cpu->ctl[__builtin_ctz(m)] = bus;
+
+        if (op->misc & MICRO_WRITE) mem[addr] = bus;
+
+        cpu->pgmFlags = (cpu->pgmFlags & ~op->pgmLatch) | (aluFlags & op->pgmLatch);
+        cpu->intFlags = (cpu->intFlags & ~op->intLatch) | (aluFlags & op->intLatch);
+
+        if (op->misc & MICRO_CLC) cpu->pgmFlags &= ~CPU_C;
+        if (op->misc & MICRO_STC) cpu->pgmFlags |= CPU_C;
+
+        if (op->pcOp == 1 && bus == cpu->irAddr) cpu->halted = true;
+
+        cpu->pc = CountOp(cpu->pc, op->pcOp, bus);
+
+        if (op->counters) {
+            cpu->ra = CountOp(cpu->ra, op->counters & 3, bus);
+            cpu->sp = CountOp(cpu->sp, (op->counters >> 2) & 3, bus);
+            cpu->intPc = CountOp(cpu->intPc, (op->counters >> 4) & 3, bus);
+            cpu->intRa = CountOp(cpu->intRa, (op->counters >> 6) & 3, bus);
+            cpu->intSp = CountOp(cpu->intSp, (op->counters >> 8) & 3, bus);
+        }
+
+        if (op->misc & MICRO_SUPPRESS) {
+            cpu->ir = OPCODE_NOP;
+        } else {
+            cpu->ir = fetch;
+            cpu->irAddr = addr;
+        }
+
+        if (cpu->halted) {
+            cpu->cycles += limit - left;
+            return limit - left;
+        }
+    }
+    DISPATCH();
+
+#undef DISPATCH
+
+
+done:
+    cpu->cycles += limit;
+
+    return limit;
+}
@@ -0,0 +1,273 @@
+//===================================================================================================================
+//  records.cc -- Write the EEPROM images as Intel HEX or Motorola S-records
+//
+//  Most programmers which take these formats leave alone any address which no record covers, so runs of the fill
+//  byte (0xff, the erased state, by default) are simply left out.  A short run is not worth the few bytes of a
+//  new record header, so it stays inside its record; anything from MIN_GAP bytes up is dropped.  Otherwise the
+//  bytes are coalesced into records of up to RECORD_BYTES.
+//
+//  Each image is read from its `ctrlN.bin` through a read-only mapping and each record is built in a fixed buffer
+//  and handed straight to stdio, so nothing is allocated per record (or per image).  Like the images, each file
+//  is written to a temporary and renamed into place.
+//
+//  Intel HEX uses type 04 records for the upper 16 bits of the address on parts bigger than 64KB.  S-records use
+//  S1/S9 for parts up to 64KB and S2/S8 above that, with an S0 header naming the image and an S5 record count.
+//
+//  -----------------------------------------------------------------------------------------------------------------
+//
+//     Date      Tracker  Version  Pgmr  Description
+//  -----------  -------  -------  ----  ---------------------------------------------------------------------------
+//  2026-Oct-16  Initial  v0.0.1   ADCL  Initial version
+//
+//===================================================================================================================
+
+
+#include <cstdint>
+#include <stdio.h>
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "eeprom.h"
+
+
+
+//
+// -- The most data bytes in one record, and the shortest run of fill bytes worth leaving out
+//    ---------------------------------------------------------------------------------------
+const int RECORD_BYTES = 32;
+const int MIN_GAP = 8;
+
+
+
+//
+// -- One record being built: the bytes (count, address, type and data) go through the checksum as they are added
+//    -----------------------------------------------------------------------------------------------------------
+typedef struct Record {
+    char text[16 + 2 * (RECORD_BYTES + 8)];
+    int len;
+    uint8_t sum;
+} Record;
+
+
+static void Start(Record *rec, char mark)
+{
+    rec->text[0] = mark;
+    rec->len = 1;
+    rec->sum = 0;
+}
+
+
+static void AddByte(Record *rec, uint8_t b)
+{
+    static const char hex[] = "0123456789ABCDEF";
+
+    rec->text[rec->len ++] = hex[b >> 4];
+    rec->text[rec->len ++] = hex[b & 0xf];
+    rec->sum += b;
+}
+
+
+static bool Finish(Record *rec, uint8_t check, FILE *fp)
+{
+    AddByte(rec, check);
+    rec->text[rec->len ++] = '\n';
+
+    return fwrite(rec->text, 1, rec->len, fp) == (size_t)rec->len;
+}
+
+
+
+//
+// -- Intel HEX:  `:LLAAAATT<data>CC`, where CC makes all the bytes sum to 0
+//    ----------------------------------------------------------------------
+static bool IntelRecord(FILE *fp, int type, uint16_t addr, const uint8_t *data, int len)
+{
+    Record rec;
+
+    Start(&rec, ':');
+    AddByte(&rec, len);
+    AddByte(&rec, addr >> 8);
+    AddByte(&rec, addr & 0xff);
+    AddByte(&rec, type);
+    for (int i = 0; i < len; i ++) AddByte(&rec, data[i]);
+
+    return Finish(&rec, -rec.sum, fp);
+}
+
+
+
+//
+// -- S-record:  `SnLL<address><data>CC`, where LL counts the address, data and checksum bytes and CC is the ones'
+//    complement of the sum of all of those and LL
+//    ------------------------------------------------------------------------------------------------------------
+static bool SRecord(FILE *fp, int type, int addrBytes, uint32_t addr, const uint8_t *data, int len)
+{
+    Record rec;
+
+    Start(&rec, 'S');
+    rec.text[rec.len ++] = '0' + type;
+    AddByte(&rec, addrBytes + len + 1);
+    for (int i = addrBytes - 1; i >= 0; i --) AddByte(&rec, addr >> (i * 8));
+    for (int i = 0; i < len; i ++) AddByte(&rec, data[i]);
+
+    return Finish(&rec, ~rec.sum, fp);
+}
+
+
+
+//
+// -- How long a record starting at `addr` should be: stop at RECORD_BYTES, at a 64KB boundary (so the Intel
+//    upper address holds for the whole record) or at a run of fill bytes worth leaving out
+//    ------------------------------------------------------------------------------------------------------
+static int RecordLength(const uint8_t *lane, int size, int addr, uint8_t fill)
+{
+    int len = 0;
+
+    while (len < RECORD_BYTES && addr + len < size && (len == 0 || ((addr + len) & 0xffff) != 0)) {
+        if (lane[addr + len] == fill) {
+            int run = 0;
+
+            while (run < MIN_GAP && addr + len + run < size && lane[addr + len + run] == fill) run ++;
+            if (run == MIN_GAP || addr + len + run == size) break;
+        }
+
+        len ++;
+    }
+
+    return len;
+}
+
+
+
+//
+// -- Stream the records for one image
+//    --------------------------------
+static bool EncodeLane(FILE *fp, int lane, const uint8_t *data, int size, RecordFormat format, uint8_t fill)
+{
+    int addrBytes = size > 0x10000 ? 3 : 2;
+    int records = 0;
+    int upper = 0;
+
+    if (format == RECORDS_SREC) {
+        if (!SRecord(fp, 0, 2, 0, (const uint8_t *)laneFile[lane], strlen(laneFile[lane]))) return false;
+    }
+
+    for (int addr = 0; addr < size; ) {
+        if (data[addr] == fill) {
+            int run = 0;
+
+            while (addr + run < size && data[addr + run] == fill) run ++;
+
+            if (run >= MIN_GAP || addr + run == size) {
+                addr += run;
+                continue;
+            }
+        }
+
+        int len = RecordLength(data, size, addr, fill);
+        bool ok;
+
+        if (format == RECORDS_IHEX) {
+            if ((addr >> 16) != upper) {
+                const uint8_t ela[2] = { (uint8_t)(addr >> 24), (uint8_t)(addr >> 16) };
+
+                upper = addr >> 16;
+                if (!IntelRecord(fp, 4, 0, ela, 2)) return false;
+            }
+
+            ok = IntelRecord(fp, 0, addr & 0xffff, &data[addr], len);
+        } else {
+            ok = SRecord(fp, addrBytes - 1, addrBytes, addr, &data[addr], len);
+        }
+
+        if (!ok) return false;
+
+        records ++;
+        addr += len;
+    }
+
+    if (format == RECORDS_IHEX) return IntelRecord(fp, 1, 0, NULL, 0);
+
+    if (records <= 0xffff && !SRecord(fp, 5, 2, records, NULL, 0)) return false;
+
+    return SRecord(fp, 11 - addrBytes, addrBytes, 0, NULL, 0);
+}
+
+
+
+//
+// -- Write one image in the text format, through a temporary file
+//    ------------------------------------------------------------
+static bool WriteLaneRecords(const char *dir, int lane, int size, RecordFormat format, uint8_t fill)
+{
+    char bin[FILENAME_MAX];
+    char path[FILENAME_MAX];
+    char tmp[FILENAME_MAX + 4];
+    struct stat st;
+
+    LanePath(bin, sizeof(bin), dir, lane);
+    LaneSidePath(path, sizeof(path), dir, lane, format == RECORDS_IHEX ? ".hex" : ".srec");
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+
+    int fd = open(bin, O_RDONLY);
+
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size != size) {
+        fprintf(stderr, "Unable to read %s: %s\n", bin, fd < 0 ? strerror(errno) : "not the size of the part");
+        if (fd >= 0) close(fd);
+        return false;
+    }
+
+    void *addr = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (addr == MAP_FAILED) {
+        fprintf(stderr, "Unable to map %s: %s\n", bin, strerror(errno));
+        return false;
+    }
+
+    FILE *fp = fopen(tmp, "w");
+
+    if (!fp) {
+        fprintf(stderr, "Unable to create %s: %s\n", tmp, strerror(errno));
+        munmap(addr, size);
+        return false;
+    }
+
+    bool ok = EncodeLane(fp, lane, (const uint8_t *)addr, size, format, fill);
+
+    munmap(addr, size);
+
+    if (fclose(fp) != 0) ok = false;
+
+    if (!ok) {
+        fprintf(stderr, "Unable to write %s: %s\n", tmp, strerror(errno));
+        unlink(tmp);
+        return false;
+    }
+
+    if (rename(tmp, path) != 0) {
+        fprintf(stderr, "Unable to rename %s to %s: %s\n", tmp, path, strerror(errno));
+        unlink(tmp);
+        return false;
+    }
+
+    return true;
+}
+
+
+
+//
+// -- Write every image in the text format
+//    ------------------------------------
+bool WriteRecords(const char *dir, int size, RecordFormat format, uint8_t fill)
+{
+    for (int l = 0; l < CTRL_LANES; l ++) {
+        if (!WriteLaneRecords(dir, l, size, format, fill)) return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,618 @@
+//===================================================================================================================
+//  regress.cc -- Run a whole corpus of programs on the simulator, on every cpu, and check how each one ended
+//
+//  `eeprom regress <corpus>` reads a list of programs, each with what it should have left behind, runs them all
+//  on the images and reports the cycles each took and whether it passed.  The point is to run the whole suite
+//  after every change to the microcode, so it has to be quick: every cpu runs programs, each with a Predecoded
+//  copy of the images shared by all of them (and a JIT of its own with `--jit`).
+//
+//  The programs take very different times, so they are handed out by work stealing.  Each thread starts with an
+//  even share of the corpus, as a range of it, and works from the front of its range.  A thread which runs out
+//  takes the back half of what is left of another thread's range, and stops when there is nothing left anywhere
+//  (running a program never makes more work, so once every range is empty, it stays empty).  Each range has a
+//  lock of its own, which is only ever held for a few instructions.
+//
+//  -----------------------------------------------------------------------------------------------------------------
+//
+//     Date      Tracker  Version  Pgmr  Description
+//  -----------  -------  -------  ----  ---------------------------------------------------------------------------
+//  2026-Oct-16  Initial  v0.0.1   ADCL  Initial version
+//
+//===================================================================================================================
+
+
+#include <cstdint>
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <ctype.h>
+#include <strings.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "sim.h"
+#include "microcode.h"
+
+
+
+//
+// -- the most checks one program can have
+//    ------------------------------------
+const int MAX_CHECKS = 32;
+
+
+//
+// -- the longest message saying why a program failed
+//    -----------------------------------------------
+const int MAX_WHY = 160;
+
+
+
+//
+// -- One thing a program should have left behind
+//    -------------------------------------------
+typedef enum {
+    CHECK_WORD,                              // a register (`off` is where it is in the Cpu)
+    CHECK_MEMORY,                            // a word of memory (`off` is its address)
+    CHECK_FLAGS,                             // the program flags
+    CHECK_CYCLES,                            // exactly this many cycles
+} CheckKind;
+
+
+typedef struct Check {
+    CheckKind kind;
+    int off;
+    uint64_t value;
+    char name[8];
+} Check;
+
+
+
+//
+// -- One program of the corpus, and how it went
+//    ------------------------------------------
+typedef struct Test {
+    char path[FILENAME_MAX];
+    int lineNo;
+    uint16_t at;
+    uint64_t limit;
+    bool running;                            // it should still be running when it reaches its limit
+    int checks;
+    Check check[MAX_CHECKS];
+
+    bool passed;
+    bool halted;
+    uint64_t cycles;
+    char why[MAX_WHY];
+} Test;
+
+
+
+//
+// -- Each thread's share of the corpus, which is the tests [head, tail)
+//    ------------------------------------------------------------------
+typedef struct alignas(64) Share {
+    pthread_mutex_t lock;
+    int head;
+    int tail;
+} Share;
+
+
+
+//
+// -- This is the work shared by all the threads
+//    ------------------------------------------
+typedef struct RegressJob {
+    Test *test;
+    const Predecoded *pd;
+    bool jit;
+    int threads;
+    Share share[MAX_THREADS];
+    int steals;                              // only touched atomically
+} RegressJob;
+
+
+typedef struct Worker {
+    RegressJob *job;
+    int self;
+} Worker;
+
+
+
+//
+// -- The names of the registers which can be checked
+//    -----------------------------------------------
+static const struct {
+    const char *name;
+    uint8_t off;
+} wordName[] = {
+    { "R1", CPU_REG(1) },   { "R2", CPU_REG(2) },   { "R3", CPU_REG(3) },   { "R4", CPU_REG(4) },
+    { "R5", CPU_REG(5) },   { "R6", CPU_REG(6) },   { "R7", CPU_REG(7) },   { "R8", CPU_REG(8) },
+    { "R9", CPU_REG(9) },   { "R10", CPU_REG(10) }, { "R11", CPU_REG(11) }, { "R12", CPU_REG(12) },
+    { "PC", CPU_AT(pc) },   { "RA", CPU_AT(ra) },   { "SP", CPU_AT(sp) },
+    { "INT_PC", CPU_AT(intPc) },                    { "INT_RA", CPU_AT(intRa) },
+    { "INT_SP", CPU_AT(intSp) },
+};
+
+
+static const char flagName[] = "ZCNVL";
+
+
+
+//
+// -- Parse one `<name>=<value>` from a line of the corpus
+//    ----------------------------------------------------
+static bool ParseCheck(const char *word, Test *t)
+{
+    const char *eq = strchr(word, '=');
+    char *end;
+
+    if (!eq || eq == word || !eq[1]) return false;
+
+    int len = eq - word;
+    const char *value = eq + 1;
+
+    if (len == 2 && strncmp(word, "at", 2) == 0) {
+        long at = strtol(value, &end, 0);
+        if (*end || at < 0 || at >= MEMORY_WORDS) return false;
+        t->at = at;
+        return true;
+    }
+
+    if (len == 5 && strncmp(word, "limit", 5) == 0) {
+        t->limit = strtoull(value, &end, 0);
+        return !*end && t->limit > 0;
+    }
+
+    if (t->checks == MAX_CHECKS) return false;
+
+    Check *c = &t->check[t->checks];
+
+    memset(c, 0, sizeof(Check));
+
+    if (len == 6 && strncmp(word, "cycles", 6) == 0) {
+        c->kind = CHECK_CYCLES;
+        c->value = strtoull(value, &end, 0);
+        strcpy(c->name, "cycles");
+        t->checks ++;
+        return !*end;
+    }
+
+    if (len == 5 && strncmp(word, "flags", 5) == 0) {
+        if (strlen(value) != 5) return false;
+
+        c->kind = CHECK_FLAGS;
+        strcpy(c->name, "flags");
+
+        for (int f = 0; f < 5; f ++) {
+            if (value[f] == flagName[f]) c->value |= 1 << f;
+            else if (value[f] != '-') return false;
+        }
+
+        t->checks ++;
+        return true;
+    }
+
+    if (word[0] == '[' && eq[-1] == ']') {
+        long addr = strtol(word + 1, &end, 0);
+        if (end != eq - 1 || addr < 0 || addr >= MEMORY_WORDS) return false;
+        c->kind = CHECK_MEMORY;
+        c->off = addr;
+        strcpy(c->name, "memory");
+    } else {
+        size_t w = 0;
+
+        while (w < sizeof(wordName) / sizeof(wordName[0]) &&
+                (strlen(wordName[w].name) != (size_t)len || strncasecmp(word, wordName[w].name, len) != 0)) w ++;
+
+        if (w == sizeof(wordName) / sizeof(wordName[0])) return false;
+
+        c->kind = CHECK_WORD;
+        c->off = wordName[w].off;
+        strcpy(c->name, wordName[w].name);
+    }
+
+    c->value = strtoul(value, &end, 0);
+    if (*end || c->value > 0xffff) return false;
+
+    t->checks ++;
+
+    return true;
+}
+
+
+
+//
+// -- Read the corpus, one program to a line:
+//
+//        <program>  [at=<addr>]  [limit=<n>]  [running]  [<register>=<value>]...  [[<addr>]=<value>]...
+//                   [flags=<ZCNVL, with - for a clear flag>]  [cycles=<n>]
+//
+//    A program halts by jumping to itself, and passes if it does so within its limit with every register, word
+//    of memory and flag it names holding the value given (and in exactly `cycles` cycles, if given).  With
+//    `running`, it must still be running when it reaches its limit instead, and is checked then.  Paths are
+//    relative to the corpus file.  Numbers are written as in C (`0x` for hex), which is how failures print
+//    them.  Anything from a `#` to the end of the line is a comment.
+//    ---------------------------------------------------------------------------------------------------------
+static int LoadCorpus(const char *corpus, uint64_t limit, Test **tests)
+{
+    char line[FILENAME_MAX];
+    int lineNo = 0;
+    int count = 0;
+    int room = 0;
+    Test *test = NULL;
+
+    const char *slash = strrchr(corpus, '/');
+    int dirLen = slash ? slash - corpus + 1 : 0;
+
+    FILE *fp = fopen(corpus, "r");
+
+    if (!fp) {
+        fprintf(stderr, "Unable to open %s: %s\n", corpus, strerror(errno));
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), fp)) {
+        lineNo ++;
+
+        char *hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+
+        char *word = strtok(line, " \t\r\n");
+        if (!word) continue;
+
+        if (count == room) {
+            room = room ? room * 2 : 64;
+            Test *more = (Test *)realloc(test, room * sizeof(Test));
+
+            if (!more) {
+                fprintf(stderr, "Out of memory\n");
+                free(test);
+                fclose(fp);
+                return -1;
+            }
+
+            test = more;
+        }
+
+        Test *t = &test[count];
+
+        memset(t, 0, sizeof(Test));
+        t->lineNo = lineNo;
+        t->limit = limit;
+
+        if (word[0] == '/' || dirLen == 0) snprintf(t->path, sizeof(t->path), "%s", word);
+        else snprintf(t->path, sizeof(t->path), "%.*s%s", dirLen, corpus, word);
+
+        while ((word = strtok(NULL, " \t\r\n")) != NULL) {
+            if (strcmp(word, "running") == 0) {
+                t->running = true;
+            } else if (!ParseCheck(word, t)) {
+                fprintf(stderr, "%s:%d: cannot make sense of `%s`\n", corpus, lineNo, word);
+                free(test);
+                fclose(fp);
+                return -1;
+            }
+        }
+
+        count ++;
+    }
+
+    fclose(fp);
+
+    if (count == 0) {
+        fprintf(stderr, "%s has no programs in it\n", corpus);
+        free(test);
+        return -1;
+    }
+
+    *tests = test;
+
+    return count;
+}
+
+
+
+//
+// -- Run one program and check how it ended
+//    --------------------------------------
+static void RunTest(Test *t, const Predecoded *pd, Jit *jit, Cpu *cpu, uint16_t *mem)
+{
+    memset(mem, 0, MEMORY_WORDS * sizeof(uint16_t));
+
+    if (!LoadProgram(t->path, mem, t->at)) {
+        snprintf(t->why, MAX_WHY, "cannot be loaded");
+        return;
+    }
+
+    ResetCpu(cpu, mem, t->at);
+
+    if (jit) {
+        ResetJit(jit);
+        RunJit(jit, cpu, t->limit);
+    } else {
+        RunPredecoded(cpu, pd, t->limit);
+    }
+
+    t->halted = cpu->halted;
+    t->cycles = cpu->cycles;
+
+    if (t->halted && t->running) {
+        snprintf(t->why, MAX_WHY, "halted at 0x%04x, but should still be running", cpu->pc);
+        return;
+    }
+
+    if (!t->halted && !t->running) {
+        snprintf(t->why, MAX_WHY, "still running at 0x%04x", cpu->pc);
+        return;
+    }
+
+    for (int i = 0; i < t->checks; i ++) {
+        const Check *c = &t->check[i];
+        uint64_t got = 0;
+
+        switch (c->kind) {
+        case CHECK_WORD:        got = CPU_WORD(cpu, c->off);            break;
+        case CHECK_MEMORY:      got = mem[c->off];                      break;
+        case CHECK_FLAGS:       got = cpu->pgmFlags;                    break;
+        case CHECK_CYCLES:      got = cpu->cycles;                      break;
+        }
+
+        if (got == c->value) continue;
+
+        if (c->kind == CHECK_FLAGS) {
+            char want[6] = "-----", have[6] = "-----";
+
+            for (int f = 0; f < 5; f ++) {
+                if (c->value & (1 << f)) want[f] = flagName[f];
+                if (got & (1 << f)) have[f] = flagName[f];
+            }
+
+            snprintf(t->why, MAX_WHY, "flags are %s, expected %s", have, want);
+        } else if (c->kind == CHECK_CYCLES) {
+            snprintf(t->why, MAX_WHY, "took %llu cycle(s), expected %llu", (unsigned long long)got,
+                    (unsigned long long)c->value);
+        } else if (c->kind == CHECK_MEMORY) {
+            snprintf(t->why, MAX_WHY, "[0x%04x] is 0x%04llx, expected 0x%04llx", c->off, (unsigned long long)got,
+                    (unsigned long long)c->value);
+        } else {
+            snprintf(t->why, MAX_WHY, "%s is 0x%04llx, expected 0x%04llx", c->name, (unsigned long long)got,
+                    (unsigned long long)c->value);
+        }
+
+        return;
+    }
+
+    t->passed = true;
+}
+
+
+
+//
+// -- Take the next test from this thread's share, or steal the back half of another thread's
+//    ---------------------------------------------------------------------------------------
+static int NextTest(RegressJob *job, int self)
+{
+    Share *mine = &job->share[self];
+    int next = -1;
+
+    pthread_mutex_lock(&mine->lock);
+    if (mine->head < mine->tail) next = mine->head ++;
+    pthread_mutex_unlock(&mine->lock);
+
+    if (next >= 0) return next;
+
+    for (int i = 1; i < job->threads && next < 0; i ++) {
+        Share *victim = &job->share[(self + i) % job->threads];
+        int from = 0, to = 0;
+
+        pthread_mutex_lock(&victim->lock);
+
+        int left = victim->tail - victim->head;
+
+        if (left > 0) {
+            from = victim->tail - (left + 1) / 2;
+            to = victim->tail;
+            victim->tail = from;
+        }
+
+        pthread_mutex_unlock(&victim->lock);
+
+        if (from == to) continue;
+
+        __atomic_fetch_add(&job->steals, 1, __ATOMIC_RELAXED);
+
+        pthread_mutex_lock(&mine->lock);
+        mine->head = from + 1;
+        mine->tail = to;
+        pthread_mutex_unlock(&mine->lock);
+
+        next = from;
+    }
+
+    return next;
+}
+
+
+
+//
+// -- Run tests until there are none left anywhere
+//    --------------------------------------------
+static void *RegressWorker(void *arg)
+{
+    Worker *w = (Worker *)arg;
+    RegressJob *job = w->job;
+    uint16_t *mem = (uint16_t *)malloc(MEMORY_WORDS * sizeof(uint16_t));
+    Jit *jit = job->jit ? OpenJit(job->pd) : NULL;
+    Cpu cpu;
+    int t;
+
+    if (!mem) {
+        fprintf(stderr, "Out of memory\n");
+        if (jit) CloseJit(jit);
+        return NULL;
+    }
+
+    while ((t = NextTest(job, w->self)) >= 0) RunTest(&job->test[t], job->pd, jit, &cpu, mem);
+
+    if (jit) CloseJit(jit);
+    free(mem);
+
+    return NULL;
+}
+
+
+
+//
+// -- Run every test on `threads` threads
+//    -----------------------------------
+static void RunCorpus(RegressJob *job, int count)
+{
+    pthread_t tid[MAX_THREADS];
+    Worker worker[MAX_THREADS];
+    int started = 0;
+
+    for (int i = 0; i < job->threads; i ++) {
+        pthread_mutex_init(&job->share[i].lock, NULL);
+        job->share[i].head = (int)((int64_t)count * i / job->threads);
+        job->share[i].tail = (int)((int64_t)count * (i + 1) / job->threads);
+        worker[i].job = job;
+        worker[i].self = i;
+    }
+
+    // -- this thread is one of the workers, so start one less; a thread which does not start leaves its share
+    //    to be stolen
+    for (int i = 1; i < job->threads; i ++) {
+        if (pthread_create(&tid[started], NULL, RegressWorker, &worker[i]) != 0) {
+            perror("Unable to start a regression thread");
+            break;
+        }
+
+        started ++;
+    }
+
+    RegressWorker(&worker[0]);
+
+    for (int i = 0; i < started; i ++) pthread_join(tid[i], NULL);
+
+    for (int i = 0; i < job->threads; i ++) pthread_mutex_destroy(&job->share[i].lock);
+}
+
+
+
+//
+// -- The `regress` subcommand
+//    ------------------------
+int Regress(const char *pgm, int argc, char *argv[])
+{
+    const char *corpus = NULL;
+    const char *microcode = NULL;
+    const char *images = NULL;
+    uint64_t limit = 100000000;
+    int threads = 0;
+    bool jit = false;
+    bool quiet = false;
+    bool usage = false;
+
+    for (int i = 0; i < argc && !usage; i ++) {
+        if (strcmp(argv[i], "--microcode") == 0 && i + 1 < argc) {
+            microcode = argv[++ i];
+        } else if (strcmp(argv[i], "--images") == 0 && i + 1 < argc) {
+            images = argv[++ i];
+        } else if (strcmp(argv[i], "--cycles") == 0 && i + 1 < argc) {
+            limit = strtoull(argv[++ i], NULL, 0);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = strtol(argv[++ i], NULL, 0);
+        } else if (strcmp(argv[i], "--jit") == 0) {
+            jit = true;
+        } else if (strcmp(argv[i], "--failures") == 0) {
+            quiet = true;
+        } else if (argv[i][0] != '-' && !corpus) {
+            corpus = argv[i];
+        } else {
+            usage = true;
+        }
+    }
+
+    if (usage || !corpus || (microcode && images) || limit == 0) {
+        fprintf(stderr, "Usage: %s regress <corpus> [--microcode <file> | --images <dir>] [--cycles <n>]\n"
+                "           [--threads <n>] [--jit] [--failures]\n", pgm);
+        return EXIT_FAILURE;
+    }
+
+
+    // -- the corpus and the images
+    Test *test;
+    int count = LoadCorpus(corpus, limit, &test);
+
+    if (count < 0) return EXIT_FAILURE;
+
+    SimRom rom;
+    Predecoded pd;
+    uint8_t *image = LoadSimRom(&rom, microcode, images);
+
+    if (!image || !Predecode(&rom, &pd)) {
+        free(image);
+        free(test);
+        return EXIT_FAILURE;
+    }
+
+    if (jit) {
+        Jit *probe = OpenJit(&pd);
+
+        if (!probe) fprintf(stderr, "%s: there is no JIT on this host; running without it\n", pgm);
+        else CloseJit(probe);
+
+        jit = probe != NULL;
+    }
+
+
+    // -- run them all
+    static RegressJob job;
+    struct timespec start, end;
+
+    if (threads <= 0) threads = sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads <= 0) threads = 1;
+    if (threads > MAX_THREADS) threads = MAX_THREADS;
+    if (threads > count) threads = count;
+
+    job.test = test;
+    job.pd = &pd;
+    job.jit = jit;
+    job.threads = threads;
+    job.steals = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    RunCorpus(&job, count);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+
+    // -- and report them in the order of the corpus
+    int passed = 0;
+    uint64_t cycles = 0;
+
+    for (int i = 0; i < count; i ++) {
+        const Test *t = &test[i];
+
+        cycles += t->cycles;
+
+        if (t->passed) passed ++;
+        if (t->passed && quiet) continue;
+
+        printf("%s %12llu  %s%s%s\n", t->passed ? "PASS" : "FAIL", (unsigned long long)t->cycles, t->path,
+                t->passed ? "" : ": ", t->why);
+    }
+
+    double secs = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    printf("%d of %d passed; %llu cycle(s) in %.3f s on %d thread(s)%s, %d steal(s)\n", passed, count,
+            (unsigned long long)cycles, secs, threads, jit ? " with the JIT" : "", job.steals);
+
+    FreePredecoded(&pd);
+    free(image);
+    free(test);
+
+    return passed == count ? EXIT_SUCCESS : EXIT_FAILURE;
+}
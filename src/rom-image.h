@@ -0,0 +1,52 @@
+//===================================================================================================================
+//  rom-image.h -- The complete EEPROM image, computed at compile time
+//
+//  Everything in here is constexpr, so the image lands in .rodata and anything which includes this header (the
+//  `eeprom` tool, a simulator, a verifier) pays nothing at startup to get the control word for any address.
+//
+//  -----------------------------------------------------------------------------------------------------------------
+//
+//     Date      Tracker  Version  Pgmr  Description
+//  -----------  -------  -------  ----  ---------------------------------------------------------------------------
+//  2026-Oct-16  Initial  v0.0.1   ADCL  Initial version (split from control.cc)
+//  2026-Oct-16  Initial  v0.0.2   ADCL  Store the image lane-major only
+//
+//===================================================================================================================
+
+
+#pragma once
+
+
+#include "microcode.h"
+
+
+//
+// -- The complete image, stored lane-major: the contents of each EEPROM are contiguous.  Only 96 of the 128 bits
+//    of a control word are wired to an EEPROM, so the words themselves are not kept; GenerateControlSignals()
+//    will produce one if it is needed.
+//    -----------------------------------------------------------------------------------------------------------
+typedef struct RomImage {
+    uint8_t lane[CTRL_LANES][PROM_SIZE];
+} RomImage;
+
+
+//
+// -- Build the complete image for the part we are using
+//    --------------------------------------------------
+constexpr RomImage BuildRomImage(void)
+{
+    RomImage image {};
+    uint8_t *const lanes[CTRL_LANES] = {
+        image.lane[0], image.lane[1], image.lane[2], image.lane[3], image.lane[ 4], image.lane[ 5],
+        image.lane[6], image.lane[7], image.lane[8], image.lane[9], image.lane[10], image.lane[11],
+    };
+
+    ExpandInstructions(opcodeTable, lanes, PROM_SIZE, 0, INSTR_COUNT);
+
+    return image;
+}
+
+
+inline constexpr RomImage romImage = BuildRomImage();
+
+
@@ -0,0 +1,177 @@
+//===================================================================================================================
+//  rom-package.cc -- Map a ROM package and check it
+//
+//  This only needs crc.cc, so a simulator or verifier can take the two of them without the rest of `eeprom`.
+//
+//  -----------------------------------------------------------------------------------------------------------------
+//
+//     Date      Tracker  Version  Pgmr  Description
+//  -----------  -------  -------  ----  ---------------------------------------------------------------------------
+//  2026-Oct-16  Initial  v0.0.1   ADCL  Initial version
+//
+//===================================================================================================================
+
+
+#include <cstdint>
+#include <stdio.h>
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "eeprom.h"
+#include "rom-package.h"
+
+
+
+//
+// -- Is the range [offset, offset + len) inside the package?
+//    -------------------------------------------------------
+static bool Inside(const RomPackage *pkg, uint64_t offset, uint64_t len)
+{
+    return offset <= pkg->length && len <= pkg->length - offset;
+}
+
+
+
+//
+// -- Check the header and tables of a mapped package
+//    -----------------------------------------------
+static const char *CheckTables(RomPackage *pkg, bool checkLanes)
+{
+    const PackageHeader *hdr = (const PackageHeader *)pkg->base;
+
+    if (pkg->length < sizeof(PackageHeader) || memcmp(hdr->magic, PACKAGE_MAGIC, sizeof(PACKAGE_MAGIC)) != 0) {
+        return "not a ROM package";
+    }
+
+    if (hdr->version != PACKAGE_VERSION) return "a package version this does not understand";
+
+    if (!Inside(pkg, hdr->laneTable, (uint64_t)hdr->laneCount * sizeof(PackageLane)) ||
+            !Inside(pkg, hdr->opcodeTable, (uint64_t)hdr->opcodeCount * sizeof(PackageOpcode)) ||
+            !Inside(pkg, hdr->strings, hdr->stringsSize) || hdr->stringsSize == 0 ||
+            pkg->base[hdr->strings + hdr->stringsSize - 1] != '\0') {
+        return "damaged (its tables are out of bounds)";
+    }
+
+    pkg->header = hdr;
+    pkg->lanes = (const PackageLane *)(pkg->base + hdr->laneTable);
+    pkg->opcodes = (const PackageOpcode *)(pkg->base + hdr->opcodeTable);
+    pkg->strings = (const char *)(pkg->base + hdr->strings);
+
+
+    // -- the tables run up to the first image, which must come after all of them
+    uint64_t end = sizeof(PackageHeader);
+    uint64_t tables = pkg->length;
+
+    if (hdr->laneTable + (uint64_t)hdr->laneCount * sizeof(PackageLane) > end) {
+        end = hdr->laneTable + (uint64_t)hdr->laneCount * sizeof(PackageLane);
+    }
+
+    if (hdr->opcodeTable + (uint64_t)hdr->opcodeCount * sizeof(PackageOpcode) > end) {
+        end = hdr->opcodeTable + (uint64_t)hdr->opcodeCount * sizeof(PackageOpcode);
+    }
+
+    if ((uint64_t)hdr->strings + hdr->stringsSize > end) end = (uint64_t)hdr->strings + hdr->stringsSize;
+
+    for (uint32_t l = 0; l < hdr->laneCount; l ++) {
+        if (!Inside(pkg, pkg->lanes[l].offset, pkg->lanes[l].size)) return "damaged (an image is out of bounds)";
+        if (pkg->lanes[l].offset < end) return "damaged (an image overlaps the tables)";
+        if (pkg->lanes[l].offset < tables) tables = pkg->lanes[l].offset;
+    }
+
+    for (uint32_t o = 0; o < hdr->opcodeCount; o ++) {
+        if (pkg->opcodes[o].name >= hdr->stringsSize) return "damaged (a name is out of bounds)";
+    }
+
+    PackageHeader copy = *hdr;
+    copy.crc = 0;
+
+    uint32_t crc = Crc32(0, (const uint8_t *)&copy, sizeof(copy));
+    crc = Crc32(crc, pkg->base + sizeof(copy), tables - sizeof(copy));
+
+    if (crc != hdr->crc) return "damaged (the header CRC does not match)";
+
+    for (uint32_t l = 0; checkLanes && l < hdr->laneCount; l ++) {
+        if (Crc32(0, PackageLaneData(pkg, l), pkg->lanes[l].size) != pkg->lanes[l].crc) {
+            return "damaged (an image CRC does not match)";
+        }
+    }
+
+    return NULL;
+}
+
+
+
+//
+// -- Map a package and check it
+//    --------------------------
+bool MapPackage(const char *path, RomPackage *pkg, bool checkLanes)
+{
+    struct stat st;
+
+    memset(pkg, 0, sizeof(*pkg));
+
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        fprintf(stderr, "Unable to open %s: %s\n", path, strerror(errno));
+        if (fd >= 0) close(fd);
+        return false;
+    }
+
+    if (st.st_size < (off_t)sizeof(PackageHeader)) {
+        fprintf(stderr, "%s is not a ROM package\n", path);
+        close(fd);
+        return false;
+    }
+
+    void *addr = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (addr == MAP_FAILED) {
+        fprintf(stderr, "Unable to map %s: %s\n", path, strerror(errno));
+        return false;
+    }
+
+    pkg->base = (const uint8_t *)addr;
+    pkg->length = st.st_size;
+
+    const char *problem = CheckTables(pkg, checkLanes);
+
+    if (problem) {
+        fprintf(stderr, "%s is %s\n", path, problem);
+        UnmapPackage(pkg);
+        return false;
+    }
+
+    return true;
+}
+
+
+
+//
+// -- Let go of a package
+//    -------------------
+void UnmapPackage(RomPackage *pkg)
+{
+    if (pkg->base) munmap((void *)pkg->base, pkg->length);
+
+    memset(pkg, 0, sizeof(*pkg));
+}
+
+
+
+//
+// -- Look up the name of an instruction
+//    ----------------------------------
+const char *PackageOpcodeName(const RomPackage *pkg, int opcode)
+{
+    for (uint32_t o = 0; o < pkg->header->opcodeCount; o ++) {
+        if (pkg->opcodes[o].opcode == (uint32_t)opcode) return pkg->strings + pkg->opcodes[o].name;
+    }
+
+    return NULL;
+}
@@ -0,0 +1,112 @@
+//===================================================================================================================
+//  rom-package.h -- One file holding every EEPROM image, for simulators and verifiers to map in one go
+//
+//  `ctrl.rom` is laid out as:
+//
+//      PackageHeader           magic, format version, build version, active-low mask and where everything else is
+//      PackageLane[laneCount]  the name, offset, size and CRC-32 of each image
+//      PackageOpcode[n]        each instruction from opcodes.h, with the offset of its name in the strings
+//      strings                 the instruction names, each ending in a NUL
+//      (padding)
+//      the images              each starting on a PACKAGE_ALIGN boundary
+//
+//  All the numbers are little-endian.  The header's `crc` covers everything ahead of the first image (taken with
+//  `crc` itself as 0), and each image has its own CRC-32 in the lane table, so a reader can check the tables
+//  alone or everything.
+//
+//  The images hold the control word with the active-low bits inverted, so the header carries the mask they were
+//  generated with; a reader XORs it back out.
+//
+//  -----------------------------------------------------------------------------------------------------------------
+//
+//     Date      Tracker  Version  Pgmr  Description
+//  -----------  -------  -------  ----  ---------------------------------------------------------------------------
+//  2026-Oct-16  Initial  v0.0.1   ADCL  Initial version
+//
+//===================================================================================================================
+
+
+#pragma once
+
+
+#include <cstdint>
+#include <cstddef>
+
+
+//
+// -- The name of the package, what is at the top of it and how the images are aligned
+//    --------------------------------------------------------------------------------
+#define PACKAGE_FILE        "ctrl.rom"
+
+const char PACKAGE_MAGIC[8] = { 'C', 'T', 'R', 'L', '-', 'R', 'O', 'M' };
+const uint32_t PACKAGE_VERSION = 1;
+const uint32_t PACKAGE_ALIGN = 4096;
+
+
+//
+// -- The file format
+//    ---------------
+typedef struct PackageHeader {
+    char magic[8];
+    uint32_t version;                        // PACKAGE_VERSION
+    uint32_t crc;                            // CRC-32 of everything ahead of the first image, with this as 0
+    char build[48];                          // the `eeprom` version and where the microcode came from
+    uint32_t laneCount;
+    uint32_t laneSize;                       // the part size
+    uint32_t laneTable;                      // the offset of the PackageLane table
+    uint32_t opcodeCount;
+    uint32_t opcodeTable;                    // the offset of the PackageOpcode table
+    uint32_t strings;                        // the offset of the names
+    uint32_t stringsSize;
+    uint32_t reserved;
+    uint64_t activeLow[2];                   // the active-low mask of the images: [0] bits 0-63, [1] bits 64-127
+} PackageHeader;
+
+
+typedef struct PackageLane {
+    char name[16];                           // the name of the image file, such as "ctrl3.bin"
+    uint32_t offset;
+    uint32_t size;
+    uint32_t crc;                            // CRC-32 of the image
+    uint32_t reserved;
+} PackageLane;
+
+
+typedef struct PackageOpcode {
+    uint32_t opcode;
+    uint32_t name;                           // the offset of the name in the strings
+} PackageOpcode;
+
+
+//
+// -- A package mapped for use
+//    ------------------------
+typedef struct RomPackage {
+    const uint8_t *base;
+    size_t length;
+    const PackageHeader *header;
+    const PackageLane *lanes;
+    const PackageOpcode *opcodes;
+    const char *strings;
+} RomPackage;
+
+
+//
+// -- Map a package and check it: always the header and tables; with `checkLanes`, the CRC of every image too.
+//    Problems are reported and return false with nothing left mapped (rom-package.cc, which needs only crc.cc).
+//    ----------------------------------------------------------------------------------------------------------
+bool MapPackage(const char *path, RomPackage *pkg, bool checkLanes);
+void UnmapPackage(RomPackage *pkg);
+
+
+//
+// -- Get at what is in a mapped package: an image by its index, and the name of an instruction (NULL if the
+//    package does not know it)
+//    ------------------------------------------------------------------------------------------------------
+inline const uint8_t *PackageLaneData(const RomPackage *pkg, int lane)
+{
+    return pkg->base + pkg->lanes[lane].offset;
+}
+
+
+const char *PackageOpcodeName(const RomPackage *pkg, int opcode);
@@ -0,0 +1,288 @@
+//===================================================================================================================
+//  serial.cc -- Talk to a programmer over a serial port, and move data across it with XMODEM-CRC
+//
+//  TommyPROM (and anything else on the other end) sees a raw 8N1 line at 115200 baud.  Blocks are the classic
+//  128 bytes: SOH, the block number, its complement, the data and a CRC-16/XMODEM (polynomial 0x1021, starting at
+//  0, sent high byte first).  The receiver asks for CRC mode by sending `C` rather than NAK.
+//
+//  -----------------------------------------------------------------------------------------------------------------
+//
+//     Date      Tracker  Version  Pgmr  Description
+//  -----------  -------  -------  ----  ---------------------------------------------------------------------------
+//  2026-Oct-16  Initial  v0.0.1   ADCL  Initial version
+//  2026-Oct-16  Initial  v0.0.2   ADCL  Let the receiver skip over chatter ahead of the first block
+//
+//===================================================================================================================
+
+
+#include <cstdint>
+#include <stdio.h>
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "eeprom.h"
+
+
+
+//
+// -- The XMODEM control characters, and how hard we try
+//    --------------------------------------------------
+const uint8_t SOH = 0x01;
+const uint8_t EOT = 0x04;
+const uint8_t ACK = 0x06;
+const uint8_t NAK = 0x15;
+const uint8_t CAN = 0x18;
+const uint8_t CRC_MODE = 'C';
+
+const int XMODEM_RETRIES = 10;
+const int XMODEM_START_MS = 60 * 1000;       // how long to wait for the receiver to ask for the first block
+const int XMODEM_ACK_MS = 10 * 1000;         // how long a block may take to be written and acknowledged
+const int XMODEM_BYTE_MS = 1000;             // the longest gap inside a block
+
+
+
+//
+// -- Open a serial port (or a pty) as a raw 115200 baud line
+//    -------------------------------------------------------
+int OpenSerial(const char *tty)
+{
+    struct termios tio;
+
+    int fd = open(tty, O_RDWR | O_NOCTTY);
+
+    if (fd < 0) {
+        fprintf(stderr, "Unable to open %s: %s\n", tty, strerror(errno));
+        return -1;
+    }
+
+    if (tcgetattr(fd, &tio) != 0) {
+        fprintf(stderr, "%s is not a serial port: %s\n", tty, strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, B115200);
+    cfsetospeed(&tio, B115200);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+
+    if (tcsetattr(fd, TCSANOW, &tio) != 0) {
+        fprintf(stderr, "Unable to set up %s: %s\n", tty, strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+
+
+//
+// -- Read one byte, waiting up to `ms` milliseconds; -1 if nothing came (or the line is gone)
+//    ----------------------------------------------------------------------------------------
+int ReadByte(int fd, int ms)
+{
+    struct pollfd pfd = { fd, POLLIN, 0 };
+    uint8_t b;
+
+    while (true) {
+        int rv = poll(&pfd, 1, ms);
+
+        if (rv < 0 && errno == EINTR) continue;
+        if (rv <= 0) return -1;
+
+        ssize_t got = read(fd, &b, 1);
+
+        if (got < 0 && (errno == EINTR || errno == EAGAIN)) continue;
+        if (got != 1) return -1;
+
+        return b;
+    }
+}
+
+
+
+//
+// -- Send everything, picking up after any short write
+//    -------------------------------------------------
+bool SendBytes(int fd, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+
+    while (len) {
+        ssize_t rv = write(fd, p, len);
+
+        if (rv < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+
+        p += rv;
+        len -= rv;
+    }
+
+    return true;
+}
+
+
+
+//
+// -- CRC-16/XMODEM
+//    -------------
+uint16_t Crc16(const uint8_t *data, size_t len)
+{
+    uint16_t crc = 0;
+
+    for (size_t i = 0; i < len; i ++) {
+        crc ^= (uint16_t)data[i] << 8;
+
+        for (int b = 0; b < 8; b ++) crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+
+    return crc;
+}
+
+
+
+//
+// -- Send `len` bytes (a multiple of XMODEM_BLOCK; anything else is padded with 0xff) to a waiting receiver
+//    ------------------------------------------------------------------------------------------------------
+bool XmodemSend(int fd, const uint8_t *data, size_t len)
+{
+    uint8_t pkt[3 + XMODEM_BLOCK + 2];
+    int c;
+
+    // -- wait for the receiver to ask for CRC mode; whatever else it says in the meantime is chatter
+    do {
+        c = ReadByte(fd, XMODEM_START_MS);
+
+        if (c < 0 || c == CAN) {
+            fprintf(stderr, "The programmer never started the XMODEM transfer\n");
+            return false;
+        }
+    } while (c != CRC_MODE);
+
+    uint8_t block = 1;
+
+    for (size_t off = 0; off < len; off += XMODEM_BLOCK, block ++) {
+        size_t n = len - off < (size_t)XMODEM_BLOCK ? len - off : XMODEM_BLOCK;
+
+        pkt[0] = SOH;
+        pkt[1] = block;
+        pkt[2] = ~block;
+        memcpy(&pkt[3], data + off, n);
+        memset(&pkt[3 + n], 0xff, XMODEM_BLOCK - n);
+
+        uint16_t crc = Crc16(&pkt[3], XMODEM_BLOCK);
+
+        pkt[3 + XMODEM_BLOCK] = crc >> 8;
+        pkt[4 + XMODEM_BLOCK] = crc & 0xff;
+
+        int tries;
+
+        for (tries = 0; tries < XMODEM_RETRIES; tries ++) {
+            if (!SendBytes(fd, pkt, sizeof(pkt))) {
+                fprintf(stderr, "Unable to send to the programmer: %s\n", strerror(errno));
+                return false;
+            }
+
+            // -- skip any stray `C`s the receiver sent before it saw the first block
+            do c = ReadByte(fd, XMODEM_ACK_MS); while (c == CRC_MODE);
+
+            if (c == ACK) break;
+
+            if (c == CAN) {
+                fprintf(stderr, "The programmer cancelled the transfer at 0x%zx\n", off);
+                return false;
+            }
+        }
+
+        if (tries == XMODEM_RETRIES) {
+            fprintf(stderr, "The programmer would not take the block at 0x%zx\n", off);
+            return false;
+        }
+    }
+
+    for (int tries = 0; tries < XMODEM_RETRIES; tries ++) {
+        if (!SendBytes(fd, &EOT, 1)) break;
+        if (ReadByte(fd, XMODEM_ACK_MS) == ACK) return true;
+    }
+
+    fprintf(stderr, "The programmer did not acknowledge the end of the transfer\n");
+    return false;
+}
+
+
+
+//
+// -- Receive a transfer, handing each block (in order, once) to `block` as it arrives so that nothing needs to
+//    hold the whole thing; returns the number of bytes received or -1.  `block` can stop the transfer by
+//    returning false.
+//    ---------------------------------------------------------------------------------------------------------
+long XmodemReceive(int fd, bool (*block)(void *ctx, const uint8_t *data, int len), void *ctx)
+{
+    uint8_t pkt[2 + XMODEM_BLOCK + 2];
+    uint8_t expect = 1;
+    long total = 0;
+    int c = -1;
+
+    // -- ask for CRC mode until the sender starts; anything before the first block is chatter (an echo, say)
+    for (int tries = 0; tries < XMODEM_START_MS / XMODEM_BYTE_MS && c < 0; tries ++) {
+        SendBytes(fd, &CRC_MODE, 1);
+
+        do c = ReadByte(fd, XMODEM_BYTE_MS); while (c >= 0 && c != SOH && c != EOT && c != CAN);
+    }
+
+    for (int errors = 0; errors < XMODEM_RETRIES; ) {
+        if (c == EOT) {
+            SendBytes(fd, &ACK, 1);
+            return total;
+        }
+
+        if (c == CAN || c < 0) break;
+
+        bool good = c == SOH;
+
+        for (size_t i = 0; good && i < sizeof(pkt); i ++) {
+            int b = ReadByte(fd, XMODEM_BYTE_MS);
+
+            if (b < 0) good = false;
+            else pkt[i] = b;
+        }
+
+        good = good && (uint8_t)~pkt[0] == pkt[1] &&
+                Crc16(&pkt[2], XMODEM_BLOCK) == ((pkt[2 + XMODEM_BLOCK] << 8) | pkt[3 + XMODEM_BLOCK]);
+
+        if (!good) {
+            // -- let the line go quiet before asking again
+            while (ReadByte(fd, XMODEM_BYTE_MS / 10) >= 0) {}
+
+            SendBytes(fd, &NAK, 1);
+            errors ++;
+        } else if (pkt[0] == (uint8_t)(expect - 1)) {
+            SendBytes(fd, &ACK, 1);      // a repeat of a block we already have; our ACK was lost
+        } else if (pkt[0] != expect) {
+            break;
+        } else {
+            if (!block(ctx, &pkt[2], XMODEM_BLOCK)) break;
+
+            SendBytes(fd, &ACK, 1);
+            total += XMODEM_BLOCK;
+            expect ++;
+            errors = 0;
+        }
+
+        c = ReadByte(fd, XMODEM_ACK_MS);
+    }
+
+    const uint8_t cancel[2] = { CAN, CAN };
+    SendBytes(fd, cancel, sizeof(cancel));
+
+    return -1;
+}
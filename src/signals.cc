@@ -0,0 +1,305 @@
+//===================================================================================================================
+//  signals.cc -- The names of the control signals, so they can be looked up at runtime
+//
+//  These have to be kept in step with the signal enum in control.h.
+//
+//  -----------------------------------------------------------------------------------------------------------------
+//
+//     Date      Tracker  Version  Pgmr  Description
+//  -----------  -------  -------  ----  ---------------------------------------------------------------------------
+//  2026-Oct-16  Initial  v0.0.1   ADCL  Initial version
+//
+//===================================================================================================================
+
+
+#include <cstdint>
+#include <cstring>
+
+#include "eeprom.h"
+
+
+
+//
+// -- Each signal, by name
+//    --------------------
+#define SIGNAL(x)       { #x, x }
+
+const SignalName signalNames[] = {
+    // -- CTRL1
+    SIGNAL(ADDR_BUS_1_ASSERT_PC),
+    SIGNAL(ADDR_BUS_1_ASSERT_RA),
+    SIGNAL(ADDR_BUS_1_ASSERT_INTPC),
+    SIGNAL(ADDR_BUS_1_ASSERT_INTRA),
+    SIGNAL(MAIN_NONE),
+    SIGNAL(MAIN_R1),
+    SIGNAL(MAIN_R2),
+    SIGNAL(MAIN_R3),
+    SIGNAL(MAIN_R4),
+    SIGNAL(MAIN_R5),
+    SIGNAL(MAIN_R6),
+    SIGNAL(MAIN_R7),
+    SIGNAL(MAIN_R8),
+    SIGNAL(MAIN_R9),
+    SIGNAL(MAIN_R10),
+    SIGNAL(MAIN_R11),
+    SIGNAL(MAIN_R12),
+    SIGNAL(MAIN_SP),
+    SIGNAL(MAIN_RA),
+    SIGNAL(MAIN_PC),
+    SIGNAL(MAIN_ISP),
+    SIGNAL(MAIN_IRA),
+    SIGNAL(MAIN_IPC),
+    SIGNAL(MAIN_FETCH),
+    SIGNAL(MAIN_DEV1),
+    SIGNAL(MAIN_DEV2),
+    SIGNAL(MAIN_DEV3),
+    SIGNAL(MAIN_DEV4),
+    SIGNAL(MAIN_DEV5),
+    SIGNAL(MAIN_DEV6),
+    SIGNAL(MAIN_DEV7),
+    SIGNAL(MAIN_DEV8),
+    SIGNAL(MAIN_DEV9),
+    SIGNAL(MAIN_DEV10),
+    SIGNAL(MAIN_ALU_ADDER),
+    SIGNAL(MAIN_MEMORY),
+    SIGNAL(MAIN_CTL1),
+    SIGNAL(MAIN_CTL2),
+    SIGNAL(MAIN_CTL3),
+    SIGNAL(MAIN_CTL4),
+    SIGNAL(MAIN_CTL5),
+    SIGNAL(MAIN_CTL6),
+    SIGNAL(MAIN_CTL7),
+    SIGNAL(MAIN_CTL8),
+    SIGNAL(MAIN_CTL9),
+    SIGNAL(MAIN_CTL10),
+
+    // -- CTRL2
+    SIGNAL(PC_DO_NOTHING),
+    SIGNAL(PC_LOAD),
+    SIGNAL(PC_INC),
+    SIGNAL(PC_DEC),
+    SIGNAL(RA_DO_NOTHING),
+    SIGNAL(RA_LOAD),
+    SIGNAL(RA_INC),
+    SIGNAL(RA_DEC),
+    SIGNAL(SP_DO_NOTHING),
+    SIGNAL(SP_LOAD),
+    SIGNAL(SP_INC),
+    SIGNAL(SP_DEC),
+    SIGNAL(INT_PC_DO_NOTHING),
+    SIGNAL(INT_PC_LOAD),
+    SIGNAL(INT_PC_INC),
+    SIGNAL(INT_PC_DEC),
+
+    // -- CTRL3
+    SIGNAL(INT_RA_DO_NOTHING),
+    SIGNAL(INT_RA_LOAD),
+    SIGNAL(INT_RA_INC),
+    SIGNAL(INT_RA_DEC),
+    SIGNAL(INT_SP_DO_NOTHING),
+    SIGNAL(INT_SP_LOAD),
+    SIGNAL(INT_SP_INC),
+    SIGNAL(INT_SP_DEC),
+    SIGNAL(MEMORY_NOTHING),
+    SIGNAL(MEMORY_WRITE),
+    SIGNAL(INSTRUCTION_ASSERT),
+    SIGNAL(INSTRUCTION_SUPPRESS),
+    SIGNAL(R1_DO_NOTHING),
+    SIGNAL(R1_LOAD),
+    SIGNAL(R2_DO_NOTHING),
+    SIGNAL(R2_LOAD),
+
+    // -- CTRL4
+    SIGNAL(R3_DO_NOTHING),
+    SIGNAL(R3_LOAD),
+    SIGNAL(R4_DO_NOTHING),
+    SIGNAL(R4_LOAD),
+    SIGNAL(R5_DO_NOTHING),
+    SIGNAL(R5_LOAD),
+    SIGNAL(R6_DO_NOTHING),
+    SIGNAL(R6_LOAD),
+    SIGNAL(R7_DO_NOTHING),
+    SIGNAL(R7_LOAD),
+    SIGNAL(R8_DO_NOTHING),
+    SIGNAL(R8_LOAD),
+    SIGNAL(R9_DO_NOTHING),
+    SIGNAL(R9_LOAD),
+    SIGNAL(R10_DO_NOTHING),
+    SIGNAL(R10_LOAD),
+
+    // -- CTRL5
+    SIGNAL(R11_DO_NOTHING),
+    SIGNAL(R11_LOAD),
+    SIGNAL(R12_DO_NOTHING),
+    SIGNAL(R12_LOAD),
+    SIGNAL(DEV01_DO_NOTHING),
+    SIGNAL(DEV01_LOAD),
+    SIGNAL(CTL01_DO_NOTHING),
+    SIGNAL(CTL01_LOAD),
+    SIGNAL(DEV02_DO_NOTHING),
+    SIGNAL(DEV02_LOAD),
+    SIGNAL(CTL02_DO_NOTHING),
+    SIGNAL(CTL02_LOAD),
+    SIGNAL(DEV03_DO_NOTHING),
+    SIGNAL(DEV03_LOAD),
+    SIGNAL(CTL03_DO_NOTHING),
+    SIGNAL(CTL03_LOAD),
+
+    // -- CTRL6
+    SIGNAL(DEV04_DO_NOTHING),
+    SIGNAL(DEV04_LOAD),
+    SIGNAL(CTL04_DO_NOTHING),
+    SIGNAL(CTL04_LOAD),
+    SIGNAL(DEV05_DO_NOTHING),
+    SIGNAL(DEV05_LOAD),
+    SIGNAL(CTL05_DO_NOTHING),
+    SIGNAL(CTL05_LOAD),
+    SIGNAL(DEV06_DO_NOTHING),
+    SIGNAL(DEV06_LOAD),
+    SIGNAL(CTL06_DO_NOTHING),
+    SIGNAL(CTL06_LOAD),
+    SIGNAL(DEV07_DO_NOTHING),
+    SIGNAL(DEV07_LOAD),
+    SIGNAL(CTL07_DO_NOTHING),
+    SIGNAL(CTL07_LOAD),
+
+    // -- CTRL7
+    SIGNAL(DEV08_DO_NOTHING),
+    SIGNAL(DEV08_LOAD),
+    SIGNAL(CTL08_DO_NOTHING),
+    SIGNAL(CTL08_LOAD),
+    SIGNAL(DEV09_DO_NOTHING),
+    SIGNAL(DEV09_LOAD),
+    SIGNAL(CTL09_DO_NOTHING),
+    SIGNAL(CTL09_LOAD),
+    SIGNAL(DEV10_DO_NOTHING),
+    SIGNAL(DEV10_LOAD),
+    SIGNAL(CTL10_DO_NOTHING),
+    SIGNAL(CTL10_LOAD),
+
+    // -- CTRL8
+    SIGNAL(CLC),
+    SIGNAL(STC),
+    SIGNAL(PGM_Z_LATCH),
+    SIGNAL(PGM_C_LATCH),
+    SIGNAL(PGM_N_LATCH),
+    SIGNAL(PGM_V_LATCH),
+    SIGNAL(PGM_L_LATCH),
+    SIGNAL(ALU_INPUT_LATCH),
+
+    // -- CTRL9
+    SIGNAL(CARRY_0),
+    SIGNAL(CARRY_LAST),
+    SIGNAL(CARRY_INVERTED),
+    SIGNAL(CARRY_1),
+    SIGNAL(INT_Z_LATCH),
+    SIGNAL(INT_C_LATCH),
+    SIGNAL(INT_N_LATCH),
+    SIGNAL(INT_V_LATCH),
+    SIGNAL(INT_L_LATCH),
+
+    // -- CTRL10
+    SIGNAL(ALUA_NONE),
+    SIGNAL(ALUA_R1),
+    SIGNAL(ALUA_R2),
+    SIGNAL(ALUA_R3),
+    SIGNAL(ALUA_R4),
+    SIGNAL(ALUA_R5),
+    SIGNAL(ALUA_R6),
+    SIGNAL(ALUA_R7),
+    SIGNAL(ALUA_R8),
+    SIGNAL(ALUA_R9),
+    SIGNAL(ALUA_R10),
+    SIGNAL(ALUA_R11),
+    SIGNAL(ALUA_R12),
+    SIGNAL(ALUA_PGM_SP),
+    SIGNAL(ALUA_INT_SP),
+    SIGNAL(ALUB_NONE),
+    SIGNAL(ALUB_R1),
+    SIGNAL(ALUB_R2),
+    SIGNAL(ALUB_R3),
+    SIGNAL(ALUB_R4),
+    SIGNAL(ALUB_R5),
+    SIGNAL(ALUB_R6),
+    SIGNAL(ALUB_R7),
+    SIGNAL(ALUB_R8),
+    SIGNAL(ALUB_R9),
+    SIGNAL(ALUB_R10),
+    SIGNAL(ALUB_R11),
+    SIGNAL(ALUB_R12),
+    SIGNAL(ALUB_FETCH),
+    SIGNAL(ALUB_MEM),
+
+    // -- Readability
+    SIGNAL(FETCH_ASSERT_MAIN),
+    SIGNAL(NOP_SIGNALS),
+    SIGNAL(ALU_LATCHES),
+};
+
+const int SIGNAL_NAME_COUNT = sizeof(signalNames) / sizeof(signalNames[0]);
+
+
+
+//
+// -- The flags an instruction can depend on, by name (without the `FLAG_`)
+//    ---------------------------------------------------------------------
+const FlagName flagNames[] = {
+    { "CONDITION",  FLAG_CONDITION },
+};
+
+const int FLAG_NAME_COUNT = sizeof(flagNames) / sizeof(flagNames[0]);
+
+
+
+//
+// -- Each instruction, by name (without the `OPCODE_`); opcode-names.h is extracted from opcodes.h by tup
+//    ----------------------------------------------------------------------------------------------------
+#include "opcodes.h"
+
+const OpcodeName opcodeNames[] = {
+#include "opcode-names.h"
+};
+
+const int OPCODE_NAME_COUNT = sizeof(opcodeNames) / sizeof(opcodeNames[0]);
+
+
+
+//
+// -- Look up a signal by name; NULL if there is no such signal
+//    ---------------------------------------------------------
+const SignalName *FindSignal(const char *name, size_t len)
+{
+    for (int i = 0; i < SIGNAL_NAME_COUNT; i ++) {
+        if (strlen(signalNames[i].name) == len && strncmp(signalNames[i].name, name, len) == 0) return &signalNames[i];
+    }
+
+    return NULL;
+}
+
+
+
+//
+// -- Look up an instruction by name; -1 if there is no such instruction
+//    ------------------------------------------------------------------
+int FindOpcode(const char *name)
+{
+    for (int i = 0; i < OPCODE_NAME_COUNT; i ++) {
+        if (strcmp(opcodeNames[i].name, name) == 0) return opcodeNames[i].opcode;
+    }
+
+    return -1;
+}
+
+
+
+//
+// -- Look up the name of an instruction; NULL if it has none
+//    -------------------------------------------------------
+const char *NameOfOpcode(int opcode)
+{
+    for (int i = 0; i < OPCODE_NAME_COUNT; i ++) {
+        if (opcodeNames[i].opcode == opcode) return opcodeNames[i].name;
+    }
+
+    return NULL;
+}
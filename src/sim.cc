@@ -0,0 +1,448 @@
+//===================================================================================================================
+//  sim.cc -- Run a program on a model of the 16-Bit Computer From Scratch, decoded through the EEPROM images
+//
+//  One call to StepCpu() is one clock.  The control word comes from the images at `(flags << 12) | instruction`,
+//  and everything it asks for is worked out from the state at the start of the clock and latched at the end of
+//  it, the way the registers on the board are clocked:
+//
+//  * Address bus 1 is driven by PC, RA, INT_PC or INT_RA, and the word at that address is fetched.  The control
+//    word does not drive a second address bus yet, so MEMORY (and ALUB_MEM, and MEMORY_WRITE) use it as well.
+//  * The main bus is driven by whichever source MAIN selects (nothing drives it as 0).
+//  * The adder adds ALUA, ALUB and the carry selected by CARRY; the flag latches take its flags.
+//  * Each register, device and control register with its load strobe takes the main bus; PC, RA, SP and the
+//    INT_* registers load, count up or count down.
+//  * The fetched word becomes the next instruction unless INSTRUCTION_SUPPRESS is set, in which case it was an
+//    immediate and the next instruction is a NOP (which is why an immediate costs a cycle).
+//
+//  A jump to itself is how a program stops, so the machine halts when PC is loaded with the address the current
+//  instruction was fetched from.
+//
+//  -----------------------------------------------------------------------------------------------------------------
+//
+//     Date      Tracker  Version  Pgmr  Description
+//  -----------  -------  -------  ----  ---------------------------------------------------------------------------
+//  2026-Oct-16  Initial  v0.0.1   ADCL  Initial version
+//  2026-Oct-16  Initial  v0.0.2   ADCL  Run from the predecoded micro-ops unless asked for the reference model
+//  2026-Oct-16  Initial  v0.0.3   ADCL  Add `--jit`
+//
+//===================================================================================================================
+
+
+#include <cstdint>
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sim.h"
+#include "microcode.h"
+
+
+
+//
+// -- The load strobes, by number
+//    ---------------------------
+const uint128_t registerLoad[REGISTERS] = {
+    0, R1_LOAD, R2_LOAD, R3_LOAD, R4_LOAD, R5_LOAD, R6_LOAD, R7_LOAD, R8_LOAD, R9_LOAD, R10_LOAD, R11_LOAD, R12_LOAD,
+};
+
+const uint128_t deviceLoad[DEVICES + 1] = {
+    0, DEV01_LOAD, DEV02_LOAD, DEV03_LOAD, DEV04_LOAD, DEV05_LOAD, DEV06_LOAD, DEV07_LOAD, DEV08_LOAD, DEV09_LOAD,
+    DEV10_LOAD,
+};
+
+const uint128_t controlLoad[DEVICES + 1] = {
+    0, CTL01_LOAD, CTL02_LOAD, CTL03_LOAD, CTL04_LOAD, CTL05_LOAD, CTL06_LOAD, CTL07_LOAD, CTL08_LOAD, CTL09_LOAD,
+    CTL10_LOAD,
+};
+
+
+
+//
+// -- Start the machine at `pc`
+//    -------------------------
+void ResetCpu(Cpu *cpu, uint16_t *mem, uint16_t pc)
+{
+    memset(cpu, 0, sizeof(Cpu));
+
+    cpu->mem = mem;
+    cpu->pc = pc;
+    cpu->ir = OPCODE_NOP;
+    cpu->irAddr = pc;
+}
+
+
+
+//
+// -- Run one clock
+//    -------------
+void StepCpu(Cpu *cpu, const SimRom *rom)
+{
+    uint128_t w = RomWord(rom, RomAddress(cpu->ir, cpu->pgmFlags));
+
+
+    // -- address bus 1 and what is fetched from it
+    uint16_t addr;
+
+    switch ((int)((w & ADDR_BUS_1_MASK) >> ADDR_BUS_1_SHIFT)) {
+    case 0:     addr = cpu->pc;         break;
+    case 1:     addr = cpu->ra;         break;
+    case 2:     addr = cpu->intPc;      break;
+    default:    addr = cpu->intRa;      break;
+    }
+
+    uint16_t fetch = cpu->mem[addr];
+
+
+    // -- the adder
+    int a = (int)((w & ALUA_MASK) >> ALUA_SHIFT);
+    int b = (int)((w & ALUB_MASK) >> ALUB_SHIFT);
+    uint16_t aluA = (a >= 1 && a <= 12) ? cpu->r[a] : a == 13 ? cpu->sp : a == 14 ? cpu->intSp : 0;
+    uint16_t aluB = (b >= 1 && b <= 12) ? cpu->r[b] : (b == 13 || b == 14) ? fetch : 0;
+    int carry;
+
+    switch ((int)((w & CARRY_MASK) >> CARRY_SHIFT)) {
+    case 0:     carry = 0;                                  break;
+    case 1:     carry = (cpu->pgmFlags & CPU_C) ? 1 : 0;    break;
+    case 2:     carry = (cpu->pgmFlags & CPU_C) ? 0 : 1;    break;
+    default:    carry = 1;                                  break;
+    }
+
+    uint8_t aluFlags;
+    uint16_t sum = Adder(aluA, aluB, carry, &aluFlags);
+
+
+    // -- the main bus
+    int src = (int)((w & MAIN_MASK) >> MAIN_SHIFT);
+    uint16_t bus;
+
+    if (src >= (int)MAIN_R1 && src <= (int)MAIN_R12) bus = cpu->r[src];
+    else if (src >= (int)MAIN_DEV1 && src <= (int)MAIN_DEV10) bus = cpu->dev[src - (int)MAIN_DEV1 + 1];
+    else if (src >= (int)MAIN_CTL1 && src <= (int)MAIN_CTL10) bus = cpu->ctl[src - (int)MAIN_CTL1 + 1];
+    else switch (src) {
+    case (int)MAIN_SP:          bus = cpu->sp;      break;
+    case (int)MAIN_RA:          bus = cpu->ra;      break;
+    case (int)MAIN_PC:          bus = cpu->pc;      break;
+    case (int)MAIN_ISP:         bus = cpu->intSp;   break;
+    case (int)MAIN_IRA:         bus = cpu->intRa;   break;
+    case (int)MAIN_IPC:         bus = cpu->intPc;   break;
+    case (int)MAIN_FETCH:       bus = fetch;        break;
+    case (int)MAIN_MEMORY:      bus = fetch;        break;
+    case (int)MAIN_ALU_ADDER:   bus = sum;          break;
+    default:                    bus = 0;            break;
+    }
+
+
+    // -- and the end of the clock: everything latches at once
+    for (int r = 1; r < REGISTERS; r ++) {
+        if (w & registerLoad[r]) cpu->r[r] = bus;
+    }
+
+    for (int d = 1; d <= DEVICES; d ++) {
+        if (w & deviceLoad[d]) cpu->dev[d] = bus;
+        if (w & controlLoad[d]) cpu->ctl[d] = bus;
+    }
+
+    if (w & MEMORY_WRITE) cpu->mem[addr] = bus;
+
+    static const uint128_t pgmLatch[] = { PGM_Z_LATCH, PGM_C_LATCH, PGM_N_LATCH, PGM_V_LATCH, PGM_L_LATCH };
+    static const uint128_t intLatch[] = { INT_Z_LATCH, INT_C_LATCH, INT_N_LATCH, INT_V_LATCH, INT_L_LATCH };
+
+    for (int f = 0; f < 5; f ++) {
+        if (w & pgmLatch[f]) cpu->pgmFlags = (cpu->pgmFlags & ~(1 << f)) | (aluFlags & (1 << f));
+        if (w & intLatch[f]) cpu->intFlags = (cpu->intFlags & ~(1 << f)) | (aluFlags & (1 << f));
+    }
+
+    if (w & CLC) cpu->pgmFlags &= ~CPU_C;
+    if (w & STC) cpu->pgmFlags |= CPU_C;
+
+    int pcOp = (int)((w & PC_DEC) >> PC_SHIFT);
+
+    if (pcOp == 1 && bus == cpu->irAddr) cpu->halted = true;
+
+    cpu->pc = CountOp(cpu->pc, pcOp, bus);
+    cpu->ra = CountOp(cpu->ra, (int)((w & RA_DEC) >> RA_SHIFT), bus);
+    cpu->sp = CountOp(cpu->sp, (int)((w & SP_DEC) >> SP_SHIFT), bus);
+    cpu->intPc = CountOp(cpu->intPc, (int)((w & INT_PC_DEC) >> INT_PC_SHIFT), bus);
+    cpu->intRa = CountOp(cpu->intRa, (int)((w & INT_RA_DEC) >> INT_RA_SHIFT), bus);
+    cpu->intSp = CountOp(cpu->intSp, (int)((w & INT_SP_DEC) >> INT_SP_SHIFT), bus);
+
+    if (w & INSTRUCTION_SUPPRESS) {
+        cpu->ir = OPCODE_NOP;
+    } else {
+        cpu->ir = fetch;
+        cpu->irAddr = addr;
+    }
+
+    cpu->cycles ++;
+}
+
+
+
+//
+// -- Run until the machine halts or `limit` cycles have gone by
+//    ----------------------------------------------------------
+uint64_t RunCpu(Cpu *cpu, const SimRom *rom, uint64_t limit)
+{
+    uint64_t start = cpu->cycles;
+
+    while (!cpu->halted && cpu->cycles - start < limit) StepCpu(cpu, rom);
+
+    return cpu->cycles - start;
+}
+
+
+
+//
+// -- Read a program of 16-bit little-endian words into memory at `at`
+//    ----------------------------------------------------------------
+bool LoadProgram(const char *path, uint16_t *mem, uint16_t at)
+{
+    FILE *fp = fopen(path, "rb");
+
+    if (!fp) {
+        fprintf(stderr, "Unable to open %s: %s\n", path, strerror(errno));
+        return false;
+    }
+
+    uint8_t w[2];
+    int addr = at;
+
+    while (fread(w, 1, 2, fp) == 2) {
+        if (addr >= MEMORY_WORDS) {
+            fprintf(stderr, "%s does not fit in memory at 0x%04x\n", path, at);
+            fclose(fp);
+            return false;
+        }
+
+        mem[addr ++] = w[0] | (w[1] << 8);
+    }
+
+    bool ok = !ferror(fp);
+
+    if (!ok) fprintf(stderr, "Unable to read %s: %s\n", path, strerror(errno));
+
+    fclose(fp);
+
+    return ok;
+}
+
+
+
+//
+// -- Print the state of the machine
+//    ------------------------------
+void PrintCpu(const Cpu *cpu)
+{
+    static const char flagName[] = "ZCNVL";
+
+    printf("PC %04x  RA %04x  SP %04x  INT_PC %04x  INT_RA %04x  INT_SP %04x  flags ", cpu->pc, cpu->ra, cpu->sp,
+            cpu->intPc, cpu->intRa, cpu->intSp);
+
+    for (int f = 0; f < 5; f ++) putchar((cpu->pgmFlags & (1 << f)) ? flagName[f] : '-');
+
+    printf("\n");
+
+    for (int r = 1; r < REGISTERS; r ++) printf("R%-2d %04x%s", r, cpu->r[r], r % 6 == 0 ? "\n" : "  ");
+
+    for (int d = 1; d <= DEVICES; d ++) {
+        if (cpu->dev[d] || cpu->ctl[d]) printf("DEV%d %04x  CTL%d %04x\n", d, cpu->dev[d], d, cpu->ctl[d]);
+    }
+}
+
+
+
+//
+// -- Trace one cycle before it runs
+//    ------------------------------
+static void TraceCpu(const Cpu *cpu)
+{
+    const char *name = NameOfOpcode(cpu->ir & (INSTR_COUNT - 1));
+
+    printf("%10llu  %04x: %04x %-16s  PC %04x  R1 %04x  R2 %04x\n", (unsigned long long)cpu->cycles, cpu->irAddr,
+            cpu->ir, name ? name : "?", cpu->pc, cpu->r[1], cpu->r[2]);
+}
+
+
+
+//
+// -- The images to run on: from the microcode in a file or from the ctrl*.bin files in a directory, decoded with
+//    the active-low mask in the `ctrl.polarity` beside them (without it there is no knowing what they mean, so
+//    they are refused).  With neither, src/microcode.txt is used if it is there, since the compiled-in microcode
+//    is only as new as the last build.  Any part size runs the same program, so only the first PROM_SIZE bytes
+//    are needed.
+//    -----------------------------------------------------------------------------------------------------------
+uint8_t *LoadSimRom(SimRom *rom, const char *microcode, const char *images)
+{
+    static OpcodeTable loaded;
+    const OpcodeTable *table = &opcodeTable;
+    uint8_t *image = (uint8_t *)malloc((size_t)PROM_SIZE * CTRL_LANES);
+    uint8_t *lanes[CTRL_LANES];
+
+    if (!image) {
+        fprintf(stderr, "Out of memory\n");
+        return NULL;
+    }
+
+    for (int l = 0; l < CTRL_LANES; l ++) {
+        lanes[l] = image + (size_t)l * PROM_SIZE;
+        rom->lane[l] = lanes[l];
+    }
+
+    rom->size = PROM_SIZE;
+    rom->activeLow = opcodeTable.activeLow;
+
+    if (!microcode && !images) {
+        if (access(DEFAULT_MICROCODE, R_OK) == 0) microcode = DEFAULT_MICROCODE;
+        else fprintf(stderr, "There is no %s here; using the compiled-in microcode\n", DEFAULT_MICROCODE);
+    }
+
+    if (images) {
+        if (!ReadPolarity(images, &rom->activeLow)) {
+            fprintf(stderr, "Unable to tell how the images in %s were generated; regenerate them\n", images);
+            free(image);
+            return NULL;
+        }
+
+        for (int l = 0; l < CTRL_LANES; l ++) {
+            if (!ReadImage(images, l, lanes[l], PROM_SIZE)) {
+                free(image);
+                return NULL;
+            }
+        }
+
+        return image;
+    }
+
+    if (microcode) {
+        if (!LoadMicrocode(microcode, &loaded)) {
+            free(image);
+            return NULL;
+        }
+
+        table = &loaded;
+        rom->activeLow = loaded.activeLow;
+    }
+
+    GenerateParallel(table, lanes, PROM_SIZE, 0);
+
+    return image;
+}
+
+
+
+//
+// -- The `simulate` subcommand: run a program until it halts and report the cycles it took
+//    -------------------------------------------------------------------------------------
+int Simulate(const char *pgm, int argc, char *argv[])
+{
+    const char *program = NULL;
+    const char *microcode = NULL;
+    const char *images = NULL;
+    uint64_t limit = 100000000;
+    long at = 0;
+    bool trace = false;
+    bool reference = false;
+    bool jit = false;
+    bool timed = false;
+
+    for (int i = 0; i < argc; i ++) {
+        if (strcmp(argv[i], "--microcode") == 0 && i + 1 < argc) {
+            microcode = argv[++ i];
+        } else if (strcmp(argv[i], "--images") == 0 && i + 1 < argc) {
+            images = argv[++ i];
+        } else if (strcmp(argv[i], "--cycles") == 0 && i + 1 < argc) {
+            limit = strtoull(argv[++ i], NULL, 0);
+        } else if (strcmp(argv[i], "--at") == 0 && i + 1 < argc) {
+            at = strtol(argv[++ i], NULL, 0);
+        } else if (strcmp(argv[i], "--trace") == 0) {
+            trace = true;
+        } else if (strcmp(argv[i], "--reference") == 0) {
+            reference = true;
+        } else if (strcmp(argv[i], "--jit") == 0) {
+            jit = true;
+        } else if (strcmp(argv[i], "--time") == 0) {
+            timed = true;
+        } else if (argv[i][0] != '-' && !program) {
+            program = argv[i];
+        } else {
+            program = NULL;
+            break;
+        }
+    }
+
+    if (!program || (microcode && images) || trace + reference + jit > 1 || at < 0 || at >= MEMORY_WORDS) {
+        fprintf(stderr, "Usage: %s simulate <program> [--microcode <file> | --images <dir>] [--cycles <n>] "
+                "[--at <addr>]\n           [--trace | --reference | --jit] [--time]\n", pgm);
+        return EXIT_FAILURE;
+    }
+
+    SimRom rom;
+    uint8_t *image = LoadSimRom(&rom, microcode, images);
+    uint16_t *mem = (uint16_t *)calloc(MEMORY_WORDS, sizeof(uint16_t));
+
+    if (!image || !mem || !LoadProgram(program, mem, at)) {
+        if (image && !mem) fprintf(stderr, "Out of memory\n");
+        free(image);
+        free(mem);
+        return EXIT_FAILURE;
+    }
+
+    Predecoded pd;
+
+    if (!trace && !reference && !Predecode(&rom, &pd)) {
+        free(image);
+        free(mem);
+        return EXIT_FAILURE;
+    }
+
+    Cpu cpu;
+    struct timespec start, end;
+
+    ResetCpu(&cpu, mem, at);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    if (trace) {
+        while (!cpu.halted && cpu.cycles < limit) {
+            TraceCpu(&cpu);
+            StepCpu(&cpu, &rom);
+        }
+    } else if (reference) {
+        RunCpu(&cpu, &rom, limit);
+    } else {
+        Jit *translator = jit ? OpenJit(&pd) : NULL;
+
+        if (jit && !translator) fprintf(stderr, "%s: no JIT on this host; running the predecoded micro-ops\n", pgm);
+
+        if (translator) {
+            RunJit(translator, &cpu, limit);
+            CloseJit(translator);
+        } else {
+            RunPredecoded(&cpu, &pd, limit);
+        }
+
+        FreePredecoded(&pd);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    if (cpu.halted) printf("%s: halted at 0x%04x after %llu cycle(s)\n", program, cpu.irAddr,
+            (unsigned long long)cpu.cycles);
+    else printf("%s: still running at 0x%04x after %llu cycle(s)\n", program, cpu.irAddr,
+            (unsigned long long)cpu.cycles);
+
+    if (timed) {
+        double secs = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+        printf("%.3f s, %.1f million cycles a second\n", secs, secs > 0 ? cpu.cycles / secs / 1e6 : 0.0);
+    }
+
+    PrintCpu(&cpu);
+
+    free(image);
+    free(mem);
+
+    return cpu.halted ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,364 @@
+//===================================================================================================================
+//  sim.h -- A simulator for the 16-Bit Computer From Scratch, driven by the EEPROM images
+//
+//  Every cycle, the instruction being executed (and whether its condition is met) is turned into an EEPROM
+//  address exactly as the board does it, `(flags << 12) | instruction`, and the control word is put back
+//  together from the 12 images at that address.  The fields of the control word then drive a model of the
+//  registers, the ALU and memory.  Nothing about an instruction is known to the simulator except through the
+//  images, so it runs whatever the microcode (or the ctrl*.bin files) say.
+//
+//  -----------------------------------------------------------------------------------------------------------------
+//
+//     Date      Tracker  Version  Pgmr  Description
+//  -----------  -------  -------  ----  ---------------------------------------------------------------------------
+//  2026-Oct-16  Initial  v0.0.1   ADCL  Initial version
+//  2026-Oct-16  Initial  v0.0.2   ADCL  Add the predecoded micro-ops
+//  2026-Oct-16  Initial  v0.0.3   ADCL  Add the JIT
+//  2026-Oct-16  Initial  v0.0.4   ADCL  Add the lockstep batch of machines
+//  2026-Oct-16  Initial  v0.0.5   ADCL  Add `ResetJit()`
+//
+//===================================================================================================================
+
+
+#pragma once
+
+
+#include <cstddef>
+
+#include "eeprom.h"
+
+
+//
+// -- The size of the machine
+//    -----------------------
+const int MEMORY_WORDS = 1 << 16;            // 16-bit addresses, 16-bit words
+const int REGISTERS = 13;                    // R1..R12; [0] is the zero register
+const int DEVICES = 10;                      // DEV1..DEV10 and CTL1..CTL10
+
+
+//
+// -- The flag bits, as they are latched from the ALU
+//    -----------------------------------------------
+enum {
+    CPU_Z                   = 1 << 0,        // the result was zero
+    CPU_C                   = 1 << 1,        // there was a carry out of bit 15
+    CPU_N                   = 1 << 2,        // the result was negative
+    CPU_V                   = 1 << 3,        // there was a signed overflow
+    CPU_L                   = 1 << 4,        // signed less than (N != V)
+};
+
+
+//
+// -- The condition in the top 4 bits of an instruction word.  The assembler does not define these yet, so this
+//    is the simulator's own choice: 0 is always, and each pair after it tests one flag set and then clear.
+//    ---------------------------------------------------------------------------------------------------------
+enum {
+    COND_ALWAYS             = 0x0,
+    COND_Z                  = 0x1,
+    COND_NZ                 = 0x2,
+    COND_C                  = 0x3,
+    COND_NC                 = 0x4,
+    COND_N                  = 0x5,
+    COND_NN                 = 0x6,
+    COND_V                  = 0x7,
+    COND_NV                 = 0x8,
+    COND_L                  = 0x9,
+    COND_NL                 = 0xa,
+    COND_NEVER              = 0xf,           // and 0xb..0xe
+};
+
+
+//
+// -- Where each field sits in the control word, worked out from the signal enum so it can never disagree
+//    ---------------------------------------------------------------------------------------------------
+constexpr int FieldShift(uint128_t mask)
+{
+    int shift = 0;
+
+    while (!((mask >> shift) & 1)) shift ++;
+
+    return shift;
+}
+
+
+const uint128_t MAIN_MASK = MAIN_R1 * 0x3f;
+const uint128_t ADDR_BUS_1_MASK = ADDR_BUS_1_ASSERT_INTRA;
+const uint128_t ALUA_MASK = ALUA_R1 * 0xf;
+const uint128_t ALUB_MASK = ALUB_R1 * 0xf;
+const uint128_t CARRY_MASK = CARRY_1;
+
+const int MAIN_SHIFT = FieldShift(MAIN_MASK);
+const int ADDR_BUS_1_SHIFT = FieldShift(ADDR_BUS_1_MASK);
+const int PC_SHIFT = FieldShift(PC_DEC);
+const int RA_SHIFT = FieldShift(RA_DEC);
+const int SP_SHIFT = FieldShift(SP_DEC);
+const int INT_PC_SHIFT = FieldShift(INT_PC_DEC);
+const int INT_RA_SHIFT = FieldShift(INT_RA_DEC);
+const int INT_SP_SHIFT = FieldShift(INT_SP_DEC);
+const int ALUA_SHIFT = FieldShift(ALUA_MASK);
+const int ALUB_SHIFT = FieldShift(ALUB_MASK);
+const int CARRY_SHIFT = FieldShift(CARRY_MASK);
+
+
+//
+// -- The load strobe for each register, device and control register, by number (0 is unused)
+//    ---------------------------------------------------------------------------------------
+extern const uint128_t registerLoad[REGISTERS];
+extern const uint128_t deviceLoad[DEVICES + 1];
+extern const uint128_t controlLoad[DEVICES + 1];
+
+
+//
+// -- The images the simulator decodes through: one pointer per EEPROM and the bits which were inverted as they
+//    were written
+//    ---------------------------------------------------------------------------------------------------------
+typedef struct SimRom {
+    const uint8_t *lane[CTRL_LANES];
+    int size;
+    uint128_t activeLow;
+} SimRom;
+
+
+//
+// -- The state of the machine
+//    ------------------------
+typedef struct Cpu {
+    uint16_t r[REGISTERS];
+    uint16_t pc, ra, sp;
+    uint16_t intPc, intRa, intSp;
+    uint16_t ir;                             // the instruction being executed
+    uint16_t irAddr;                         // ... and where it was fetched from
+    uint16_t dev[DEVICES + 1];               // DEV1..DEV10
+    uint16_t ctl[DEVICES + 1];               // CTL1..CTL10
+    uint8_t pgmFlags;
+    uint8_t intFlags;
+    bool halted;                             // a jump to itself has been reached
+    uint64_t cycles;
+    uint16_t *mem;
+} Cpu;
+
+
+//
+// -- Is the condition in an instruction met by the flags?
+//    ----------------------------------------------------
+inline bool ConditionMet(int cond, uint8_t flags)
+{
+    switch (cond) {
+    case COND_ALWAYS:   return true;
+    case COND_Z:        return flags & CPU_Z;
+    case COND_NZ:       return !(flags & CPU_Z);
+    case COND_C:        return flags & CPU_C;
+    case COND_NC:       return !(flags & CPU_C);
+    case COND_N:        return flags & CPU_N;
+    case COND_NN:       return !(flags & CPU_N);
+    case COND_V:        return flags & CPU_V;
+    case COND_NV:       return !(flags & CPU_V);
+    case COND_L:        return flags & CPU_L;
+    case COND_NL:       return !(flags & CPU_L);
+    default:            return false;
+    }
+}
+
+
+//
+// -- The EEPROM address for an instruction given the flags: the board's `(flags << 12) | instruction`
+//    ------------------------------------------------------------------------------------------------
+inline int RomAddress(uint16_t ir, uint8_t flags)
+{
+    return ((ConditionMet(ir >> 12, flags) ? 0 : FLAG_CONDITION) << 12) | (ir & (INSTR_COUNT - 1));
+}
+
+
+//
+// -- Put the control word at an address back together from the images, undoing the active-low bits
+//    ---------------------------------------------------------------------------------------------
+inline uint128_t RomWord(const SimRom *rom, int addr)
+{
+    uint128_t word = 0;
+
+    for (int l = 0; l < CTRL_LANES; l ++) word |= (uint128_t)rom->lane[l][addr] << (l * 8);
+
+    return word ^ (rom->activeLow & (((uint128_t)1 << (CTRL_LANES * 8)) - 1));
+}
+
+
+//
+// -- The adder, with the flags it would latch
+//    ----------------------------------------
+inline uint16_t Adder(uint16_t a, uint16_t b, int carry, uint8_t *flags)
+{
+    uint32_t sum = (uint32_t)a + b + carry;
+    uint16_t res = sum;
+    uint8_t f = 0;
+
+    if (res == 0) f |= CPU_Z;
+    if (sum > 0xffff) f |= CPU_C;
+    if (res & 0x8000) f |= CPU_N;
+    if (~(a ^ b) & (a ^ res) & 0x8000) f |= CPU_V;
+    if (!(f & CPU_N) != !(f & CPU_V)) f |= CPU_L;
+
+    *flags = f;
+
+    return res;
+}
+
+
+//
+// -- The counter registers: 0 leaves it, 1 loads the main bus, 2 counts up and 3 counts down
+//    ---------------------------------------------------------------------------------------
+inline uint16_t CountOp(uint16_t reg, int op, uint16_t bus)
+{
+    switch (op) {
+    case 1:     return bus;
+    case 2:     return reg + 1;
+    case 3:     return reg - 1;
+    default:    return reg;
+    }
+}
+
+
+//
+// -- The microcode the simulator runs when it is not given `--microcode` or `--images`
+//    ---------------------------------------------------------------------------------
+const char *const DEFAULT_MICROCODE = "src/microcode.txt";
+
+
+//
+// -- Run the machine (sim.cc).  ResetCpu() starts it at `pc` with nothing in the instruction register (the same
+//    as after a suppressed fetch); StepCpu() runs one cycle; RunCpu() runs until the machine halts or `limit`
+//    cycles have gone by, and returns the cycles it ran.  LoadProgram() reads a program (raw 16-bit words,
+//    little-endian) into memory at `at`, and reports any failure.  LoadSimRom() gets the images from the microcode
+//    in a file (DEFAULT_MICROCODE when none is given) or from the ctrl*.bin files and ctrl.polarity in a directory,
+//    and returns the memory to free.
+//    --------------------------------------------------------------------------------------------------------------
+void ResetCpu(Cpu *cpu, uint16_t *mem, uint16_t pc);
+void StepCpu(Cpu *cpu, const SimRom *rom);
+uint64_t RunCpu(Cpu *cpu, const SimRom *rom, uint64_t limit);
+bool LoadProgram(const char *path, uint16_t *mem, uint16_t at);
+void PrintCpu(const Cpu *cpu);
+uint8_t *LoadSimRom(SimRom *rom, const char *microcode, const char *images);
+
+
+//
+// -- A control word, predecoded into what it does.  Registers are named by their byte offset in Cpu (R1..R12 by
+//    `offsetof(Cpu, r[n])`, and nothing by `r[0]`, which is never loaded and always 0), so a source is one load.
+//    -----------------------------------------------------------------------------------------------------------
+enum {
+    MICRO_NOP               = 0,             // exactly NOP_SIGNALS: fetch the next instruction
+    MICRO_SKIP              = 1,             // NOP_SIGNALS | INSTRUCTION_SUPPRESS: step over an immediate
+    MICRO_GENERAL           = 2,             // anything else
+};
+
+enum {
+    MICRO_WRITE             = 1 << 0,        // MEMORY_WRITE
+    MICRO_SUPPRESS          = 1 << 1,        // INSTRUCTION_SUPPRESS
+    MICRO_CLC               = 1 << 2,
+    MICRO_STC               = 1 << 3,
+    MICRO_ALU               = 1 << 4,        // the adder is used (on the main bus or by a flag latch)
+};
+
+const uint8_t SRC_FETCH = 0xfe;              // the fetched word (MAIN_FETCH, MAIN_MEMORY, ALUB_FETCH, ALUB_MEM)
+const uint8_t SRC_ALU = 0xff;                // the adder (MAIN_ALU_ADDER)
+
+#define CPU_REG(n)          ((uint8_t)(offsetof(Cpu, r) + (n) * sizeof(uint16_t)))
+#define CPU_DEV(n)          ((uint8_t)(offsetof(Cpu, dev) + (n) * sizeof(uint16_t)))
+#define CPU_CTL(n)          ((uint8_t)(offsetof(Cpu, ctl) + (n) * sizeof(uint16_t)))
+#define CPU_AT(field)       ((uint8_t)offsetof(Cpu, field))
+#define CPU_WORD(cpu, off)  (*(uint16_t *)((uint8_t *)(cpu) + (off)))
+
+typedef struct MicroOp {
+    uint8_t kind;                            // MICRO_NOP, MICRO_SKIP or MICRO_GENERAL
+    uint8_t misc;                            // MICRO_WRITE etc.
+    uint8_t addr;                            // the register on address bus 1
+    uint8_t src;                             // the register on the main bus, or SRC_FETCH/SRC_ALU
+    uint8_t aluA;                            // the registers into the adder (aluB may be SRC_FETCH)
+    uint8_t aluB;
+    uint8_t carry;                           // the CARRY field
+    uint8_t pgmLatch;                        // the CPU_* flags latched
+    uint8_t intLatch;
+    uint8_t pcOp;                            // the PC field
+    uint16_t counters;                       // the RA, SP, INT_PC, INT_RA and INT_SP fields, 2 bits each
+    uint16_t regLoad;                        // bit n loads Rn
+    uint16_t devLoad;                        // bit n loads DEVn
+    uint16_t ctlLoad;                        // bit n loads CTLn
+} MicroOp;
+
+
+//
+// -- Every control word the images hold, predecoded.  `index` is instruction-major: both versions of an
+//    instruction (condition met, then not met) sit together, and name the distinct words in `op`.  `met[cond]`
+//    has bit f set when the condition is met by the flags f.
+//    ---------------------------------------------------------------------------------------------------------
+typedef struct Predecoded {
+    uint16_t index[INSTR_COUNT][2];
+    uint32_t met[16];
+    int count;
+    MicroOp *op;
+} Predecoded;
+
+
+//
+// -- Predecode the images (predecode.cc), find the MicroOp for the next cycle, and run until the machine halts or
+//    `limit` cycles have gone by; the machine ends up exactly as RunCpu() would leave it
+//    ------------------------------------------------------------------------------------------------------------
+inline const MicroOp *CurrentOp(const Predecoded *pd, const Cpu *cpu)
+{
+    return &pd->op[pd->index[cpu->ir & (INSTR_COUNT - 1)][!((pd->met[cpu->ir >> 12] >> cpu->pgmFlags) & 1)]];
+}
+
+bool Predecode(const SimRom *rom, Predecoded *pd);
+void FreePredecoded(Predecoded *pd);
+MicroOp DecodeWord(uint128_t word);
+uint64_t RunPredecoded(Cpu *cpu, const Predecoded *pd, uint64_t limit);
+
+
+//
+// -- Translate straight-line runs of the program to x86-64 and run them (jit.cc).  OpenJit() returns NULL when
+//    there is no JIT on this host (or it cannot map code); RunJit() leaves the machine as RunPredecoded() would.
+//    ResetJit() throws away every translation, for when another program is loaded behind its back.
+//    -----------------------------------------------------------------------------------------------------------
+typedef struct Jit Jit;
+
+Jit *OpenJit(const Predecoded *pd);
+void CloseJit(Jit *jit);
+void ResetJit(Jit *jit);
+uint64_t RunJit(Jit *jit, Cpu *cpu, uint64_t limit);
+
+
+//
+// -- A batch of machines run in lockstep, one to each lane of a vector: every register holds the 16 machines'
+//    values side by side, and so does every word of memory, so when all the machines are at the same instruction
+//    and address a cycle is a handful of vector operations for all of them.  `active` has a bit for each machine
+//    which has not halted, and `cycles` is how long each ran before it did.
+//    -----------------------------------------------------------------------------------------------------------
+const int SIMD_LANES = 16;
+
+typedef uint16_t LaneWords[SIMD_LANES];
+
+typedef struct CpuBatch {
+    alignas(32) LaneWords r[REGISTERS];
+    LaneWords pc, ra, sp;
+    LaneWords intPc, intRa, intSp;
+    LaneWords ir;
+    LaneWords irAddr;
+    LaneWords dev[DEVICES + 1];
+    LaneWords ctl[DEVICES + 1];
+    LaneWords pgmFlags;
+    LaneWords intFlags;
+    uint32_t active;
+    uint32_t halting;                        // the machines which halt in this cycle
+    uint64_t cycle;                          // the cycles the batch has run
+    uint64_t cycles[SIMD_LANES];
+    uint64_t divergent;                      // the cycles which had to be run one machine at a time
+    int dirtyLo, dirtyHi;                    // the range of memory written
+    LaneWords *mem;                          // MEMORY_WORDS of them
+} CpuBatch;
+
+
+//
+// -- Run a batch (lockstep.cc).  ResetBatch() starts every machine at `pc`, with the lanes given by `lanes`
+//    active; RunBatch() runs until every machine halts or `limit` cycles have gone by.  Each machine ends up
+//    exactly as RunCpu() would leave it.
+//    -------------------------------------------------------------------------------------------------------
+void ResetBatch(CpuBatch *b, LaneWords *mem, uint16_t pc, uint32_t lanes);
+uint64_t RunBatch(CpuBatch *b, const Predecoded *pd, uint64_t limit);
@@ -0,0 +1,689 @@
+//===================================================================================================================
+//  store.cc -- Keep every set of images ever generated, so any earlier build can be brought back or compared
+//
+//  The store is a directory (`ctrl.store` by default) holding three things:
+//
+//      pages        every distinct 64-byte page ever seen, one after the other; a page is found by its FNV-1a hash,
+//                   and the index is rebuilt from the contents each time the store is opened
+//      lanes/<hash> every distinct image, as the number of each of its pages in `pages`; named by the FNV-1a hash
+//                   of the image itself
+//      builds       one line per set of images stored, oldest first:
+//
+//          <id> <yyyy-mm-ddThh:mm:ss> <size> <hash of ctrl1.bin> ... <hash of ctrlc.bin> activeLow=<mask> <source>
+//
+//                   where <mask> is the 32 hex digits of the active-low mask the images were made with (they
+//                   cannot be decoded without it) and <source> is where the microcode came from
+//
+//  A new build usually only differs from the last in a few pages, so it adds those pages and a new page list for
+//  each image that changed; the images which did not change are already there.  The build id is the hash of its
+//  size and image hashes, so building the same microcode again gives the same id.
+//
+//  Pages are added before the page lists that use them, and the build line last, so a run which is interrupted
+//  leaves at worst some pages nothing refers to.
+//
+//  -----------------------------------------------------------------------------------------------------------------
+//
+//     Date      Tracker  Version  Pgmr  Description
+//  -----------  -------  -------  ----  ---------------------------------------------------------------------------
+//  2026-Oct-16  Initial  v0.0.1   ADCL  Initial version
+//
+//===================================================================================================================
+
+
+#include <cstdint>
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "eeprom.h"
+
+
+
+//
+// -- The store as it is worked on: every page (those on disk, then those added this run) and an open-addressed
+//    index from page hash to page number
+//    ---------------------------------------------------------------------------------------------------------
+typedef struct Store {
+    const char *dir;
+    uint8_t *pages;
+    uint32_t count;                          // the pages in `pages`
+    uint32_t onDisk;                         // ... of which this many are already in the file
+    uint32_t capacity;                       // the pages `pages` has room for
+    uint32_t *index;                         // page number + 1 for each slot, 0 when empty
+    uint32_t slots;                          // a power of 2, at least twice `capacity`
+} Store;
+
+
+//
+// -- One line of the build log
+//    -------------------------
+typedef struct Build {
+    char id[17];
+    char when[20];
+    int size;
+    uint64_t lane[CTRL_LANES];
+    uint128_t activeLow;
+    char source[FILENAME_MAX];
+} Build;
+
+
+
+//
+// -- Build the path to something in the store
+//    ----------------------------------------
+static void StorePath(char *path, size_t len, const char *dir, const char *name)
+{
+    snprintf(path, len, "%s/%s", dir, name);
+}
+
+
+static void LaneListPath(char *path, size_t len, const char *dir, uint64_t hash)
+{
+    snprintf(path, len, "%s/lanes/%016llx", dir, (unsigned long long)hash);
+}
+
+
+
+//
+// -- Find the slot for a page: either the one holding it, or the empty one where it belongs
+//    --------------------------------------------------------------------------------------
+static uint32_t FindSlot(const Store *store, const uint8_t *page, uint64_t hash)
+{
+    uint32_t slot = hash & (store->slots - 1);
+
+    while (store->index[slot]) {
+        const uint8_t *there = store->pages + (size_t)(store->index[slot] - 1) * EEPROM_PAGE_SIZE;
+
+        if (memcmp(there, page, EEPROM_PAGE_SIZE) == 0) break;
+
+        slot = (slot + 1) & (store->slots - 1);
+    }
+
+    return slot;
+}
+
+
+
+//
+// -- Make room for `more` pages, rebuilding the index if it has to grow
+//    ------------------------------------------------------------------
+static bool Reserve(Store *store, uint32_t more)
+{
+    if (store->index && store->count + more <= store->capacity) return true;
+
+    uint32_t capacity = store->capacity ? store->capacity : 1024;
+
+    while (capacity < store->count + more) capacity *= 2;
+
+    uint8_t *pages = (uint8_t *)realloc(store->pages, (size_t)capacity * EEPROM_PAGE_SIZE);
+    uint32_t *index = (uint32_t *)calloc((size_t)capacity * 2, sizeof(uint32_t));
+
+    if (!pages || !index) {
+        if (pages) store->pages = pages;
+        free(index);
+        fprintf(stderr, "Out of memory\n");
+        return false;
+    }
+
+    free(store->index);
+    store->pages = pages;
+    store->capacity = capacity;
+    store->index = index;
+    store->slots = capacity * 2;
+
+    for (uint32_t p = 0; p < store->count; p ++) {
+        const uint8_t *page = store->pages + (size_t)p * EEPROM_PAGE_SIZE;
+
+        store->index[FindSlot(store, page, Fnv1a(FNV_OFFSET, page, EEPROM_PAGE_SIZE))] = p + 1;
+    }
+
+    return true;
+}
+
+
+
+//
+// -- The number of a page, adding it if this is the first time it has been seen
+//    --------------------------------------------------------------------------
+static uint32_t AddPage(Store *store, const uint8_t *page)
+{
+    uint32_t slot = FindSlot(store, page, Fnv1a(FNV_OFFSET, page, EEPROM_PAGE_SIZE));
+
+    if (store->index[slot]) return store->index[slot] - 1;
+
+    memcpy(store->pages + (size_t)store->count * EEPROM_PAGE_SIZE, page, EEPROM_PAGE_SIZE);
+    store->index[slot] = ++ store->count;
+
+    return store->count - 1;
+}
+
+
+
+//
+// -- Open the store, creating it if needed, and read in every page; with `create` false it must already exist
+//    --------------------------------------------------------------------------------------------------------
+static bool OpenStore(Store *store, const char *dir, bool create)
+{
+    char path[FILENAME_MAX];
+    struct stat st;
+
+    memset(store, 0, sizeof(Store));
+    store->dir = dir;
+
+    if (create) {
+        StorePath(path, sizeof(path), dir, "lanes");
+
+        if ((mkdir(dir, 0755) != 0 && errno != EEXIST) || (mkdir(path, 0755) != 0 && errno != EEXIST)) {
+            fprintf(stderr, "Unable to create %s: %s\n", path, strerror(errno));
+            return false;
+        }
+    }
+
+    StorePath(path, sizeof(path), dir, "pages");
+
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0) {
+        if (errno == ENOENT && create) return Reserve(store, 0);
+
+        fprintf(stderr, "Unable to open %s: %s\n", path, strerror(errno));
+        return false;
+    }
+
+    // -- a partial page at the end was being added when a run stopped; it is written over
+    uint32_t count = fstat(fd, &st) == 0 ? st.st_size / EEPROM_PAGE_SIZE : 0;
+
+    if (!Reserve(store, count)) {
+        close(fd);
+        return false;
+    }
+
+    if (read(fd, store->pages, (size_t)count * EEPROM_PAGE_SIZE) != (ssize_t)count * EEPROM_PAGE_SIZE) {
+        fprintf(stderr, "Unable to read %s: %s\n", path, strerror(errno));
+        close(fd);
+        return false;
+    }
+
+    close(fd);
+
+    // -- a page is only ever added once, so each goes straight into its slot
+    for (uint32_t p = 0; p < count; p ++) {
+        const uint8_t *page = store->pages + (size_t)p * EEPROM_PAGE_SIZE;
+        uint32_t slot = FindSlot(store, page, Fnv1a(FNV_OFFSET, page, EEPROM_PAGE_SIZE));
+
+        if (!store->index[slot]) store->index[slot] = p + 1;
+    }
+
+    store->count = count;
+    store->onDisk = count;
+
+    return true;
+}
+
+
+static void CloseStore(Store *store)
+{
+    free(store->pages);
+    free(store->index);
+}
+
+
+
+//
+// -- Append the pages added this run to the file
+//    -------------------------------------------
+static bool FlushPages(Store *store)
+{
+    char path[FILENAME_MAX];
+    size_t len = (size_t)(store->count - store->onDisk) * EEPROM_PAGE_SIZE;
+    off_t at = (off_t)store->onDisk * EEPROM_PAGE_SIZE;
+    const uint8_t *data = store->pages + at;
+
+    if (len == 0) return true;
+
+    StorePath(path, sizeof(path), store->dir, "pages");
+
+    int fd = open(path, O_WRONLY | O_CREAT, 0644);
+
+    if (fd < 0) {
+        fprintf(stderr, "Unable to open %s: %s\n", path, strerror(errno));
+        return false;
+    }
+
+    while (len) {
+        ssize_t rv = pwrite(fd, data, len, at);
+
+        if (rv < 0) {
+            if (errno == EINTR) continue;
+
+            fprintf(stderr, "Unable to write %s: %s\n", path, strerror(errno));
+            close(fd);
+            return false;
+        }
+
+        data += rv;
+        at += rv;
+        len -= rv;
+    }
+
+    if (close(fd) != 0) {
+        fprintf(stderr, "Unable to close %s: %s\n", path, strerror(errno));
+        return false;
+    }
+
+    store->onDisk = store->count;
+
+    return true;
+}
+
+
+
+//
+// -- Parse one line of the build log; false if it is not one
+//    -------------------------------------------------------
+static bool ParseBuild(const char *line, Build *build)
+{
+    int used = 0;
+
+    if (sscanf(line, "%16s %19s %d%n", build->id, build->when, &build->size, &used) != 3) return false;
+
+    line += used;
+
+    for (int l = 0; l < CTRL_LANES; l ++) {
+        unsigned long long hash;
+
+        if (sscanf(line, " %16llx%n", &hash, &used) != 1) return false;
+
+        build->lane[l] = hash;
+        line += used;
+    }
+
+    unsigned long long hi, lo;
+
+    if (sscanf(line, " activeLow=%16llx%16llx%n", &hi, &lo, &used) != 2) return false;
+
+    build->activeLow = ((uint128_t)hi << 64) | lo;
+    line += used;
+
+    while (*line == ' ') line ++;
+
+    snprintf(build->source, sizeof(build->source), "%.*s", (int)strcspn(line, "\n"), line);
+
+    return true;
+}
+
+
+
+//
+// -- Find a build by (the start of) its id; if it was stored more than once, the latest is used
+//    ------------------------------------------------------------------------------------------
+static bool FindBuild(const char *dir, const char *id, Build *build)
+{
+    char path[FILENAME_MAX];
+    char line[FILENAME_MAX + 512];
+    Build cur;
+    bool found = false;
+
+    StorePath(path, sizeof(path), dir, "builds");
+
+    FILE *fp = fopen(path, "r");
+
+    if (!fp) {
+        fprintf(stderr, "Unable to open %s: %s\n", path, strerror(errno));
+        return false;
+    }
+
+    while (fgets(line, sizeof(line), fp)) {
+        if (!ParseBuild(line, &cur)) continue;
+
+        if (strncmp(cur.id, id, strlen(id)) == 0) {
+            if (found && strcmp(cur.id, build->id) != 0) {
+                fprintf(stderr, "%s: more than one build starts with %s\n", path, id);
+                fclose(fp);
+                return false;
+            }
+
+            *build = cur;
+            found = true;
+        }
+    }
+
+    fclose(fp);
+
+    if (!found) fprintf(stderr, "%s: no build %s\n", path, id);
+
+    return found;
+}
+
+
+
+//
+// -- Bring back one image of a build, checking it comes out with the hash it went in with
+//    ------------------------------------------------------------------------------------
+static bool LoadLane(const Store *store, uint64_t hash, uint8_t *data, int size)
+{
+    static uint32_t list[MAX_PROM_SIZE / EEPROM_PAGE_SIZE];
+    char path[FILENAME_MAX];
+    int pages = size / EEPROM_PAGE_SIZE;
+    struct stat st;
+
+    LaneListPath(path, sizeof(path), store->dir, hash);
+
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size != (off_t)(pages * sizeof(uint32_t)) ||
+            read(fd, list, st.st_size) != st.st_size) {
+        fprintf(stderr, "Unable to read %s: %s\n", path, fd < 0 ? strerror(errno) : "not the size of the part");
+        if (fd >= 0) close(fd);
+        return false;
+    }
+
+    close(fd);
+
+    for (int p = 0; p < pages; p ++) {
+        if (list[p] >= store->count) {
+            fprintf(stderr, "%s: page %u is not in the store\n", path, list[p]);
+            return false;
+        }
+
+        memcpy(data + p * EEPROM_PAGE_SIZE, store->pages + (size_t)list[p] * EEPROM_PAGE_SIZE, EEPROM_PAGE_SIZE);
+    }
+
+    if (Fnv1a(FNV_OFFSET, data, size) != hash) {
+        fprintf(stderr, "%s: the image does not match its hash; the store is damaged\n", path);
+        return false;
+    }
+
+    return true;
+}
+
+
+static bool LoadBuild(const Store *store, const Build *build, uint8_t *const lanes[CTRL_LANES])
+{
+    for (int l = 0; l < CTRL_LANES; l ++) {
+        if (!LoadLane(store, build->lane[l], lanes[l], build->size)) return false;
+    }
+
+    return true;
+}
+
+
+
+//
+// -- Add the images in `dir` to the store as a new build
+//    ---------------------------------------------------
+bool StoreImages(const char *store, const char *dir, int size, const char *source, uint128_t activeLow)
+{
+    static uint32_t list[MAX_PROM_SIZE / EEPROM_PAGE_SIZE];
+    char path[FILENAME_MAX];
+    uint64_t hash[CTRL_LANES];
+    int pages = size / EEPROM_PAGE_SIZE;
+    int newLanes = 0;
+    Store st;
+
+    uint8_t *image = (uint8_t *)malloc(size);
+
+    if (!image) {
+        fprintf(stderr, "Out of memory\n");
+        return false;
+    }
+
+    if (!OpenStore(&st, store, true) || !Reserve(&st, CTRL_LANES * pages)) {
+        CloseStore(&st);
+        free(image);
+        return false;
+    }
+
+    uint32_t before = st.count;
+    uint64_t id = Fnv1a(FNV_OFFSET, &size, sizeof(size));
+    bool ok = true;
+
+
+    // -- each image: its pages first, then its page list if it is a new one
+    for (int l = 0; ok && l < CTRL_LANES; l ++) {
+        ok = ReadImage(dir, l, image, size);
+        if (!ok) break;
+
+        hash[l] = Fnv1a(FNV_OFFSET, image, size);
+        id = Fnv1a(id, &hash[l], sizeof(hash[l]));
+
+        LaneListPath(path, sizeof(path), store, hash[l]);
+        if (access(path, F_OK) == 0) continue;
+
+        for (int p = 0; p < pages; p ++) list[p] = AddPage(&st, image + p * EEPROM_PAGE_SIZE);
+
+        ok = FlushPages(&st) && WriteFileAtomic(path, (const uint8_t *)list, pages * sizeof(uint32_t));
+        newLanes ++;
+    }
+
+    free(image);
+
+
+    // -- and then the build itself
+    if (ok) {
+        char when[20];
+        time_t now = time(NULL);
+
+        strftime(when, sizeof(when), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+        StorePath(path, sizeof(path), store, "builds");
+
+        FILE *fp = fopen(path, "a");
+
+        if (!fp) {
+            fprintf(stderr, "Unable to open %s: %s\n", path, strerror(errno));
+            ok = false;
+        } else {
+            fprintf(fp, "%016llx %s %d", (unsigned long long)id, when, size);
+            for (int l = 0; l < CTRL_LANES; l ++) fprintf(fp, " %016llx", (unsigned long long)hash[l]);
+            fprintf(fp, " activeLow=%016llx%016llx %s\n", (unsigned long long)(activeLow >> 64),
+                    (unsigned long long)activeLow, source);
+
+            if (fclose(fp) != 0) {
+                fprintf(stderr, "Unable to write %s: %s\n", path, strerror(errno));
+                ok = false;
+            }
+        }
+    }
+
+    if (ok) {
+        printf("%s: build %016llx stored; %d new image(s), %u new page(s) (%u in the store)\n", store,
+                (unsigned long long)id, newLanes, st.count - before, st.count);
+    }
+
+    CloseStore(&st);
+
+    return ok;
+}
+
+
+
+//
+// -- List the builds, with how many images each changed from the one before
+//    ----------------------------------------------------------------------
+static bool ListBuilds(const char *dir)
+{
+    char path[FILENAME_MAX];
+    char line[FILENAME_MAX + 512];
+    Build cur, last;
+    bool have = false;
+    Store st;
+
+    if (!OpenStore(&st, dir, false)) return false;
+
+    StorePath(path, sizeof(path), dir, "builds");
+
+    FILE *fp = fopen(path, "r");
+
+    if (!fp) {
+        fprintf(stderr, "Unable to open %s: %s\n", path, strerror(errno));
+        CloseStore(&st);
+        return false;
+    }
+
+    printf("%-16s  %-19s  %7s  %7s  %s\n", "build", "when", "size", "changed", "source");
+
+    while (fgets(line, sizeof(line), fp)) {
+        if (!ParseBuild(line, &cur)) continue;
+
+        int lanes = 0;
+
+        for (int l = 0; l < CTRL_LANES; l ++) {
+            if (!have || last.size != cur.size || last.lane[l] != cur.lane[l]) lanes ++;
+        }
+
+        printf("%-16s  %-19s  %7d  %7d  %s\n", cur.id, cur.when, cur.size, lanes, cur.source);
+
+        last = cur;
+        have = true;
+    }
+
+    fclose(fp);
+    printf("%u distinct page(s), %u byte(s), in %s\n", st.count, st.count * EEPROM_PAGE_SIZE, dir);
+    CloseStore(&st);
+
+    return true;
+}
+
+
+
+//
+// -- Print the runs of pages which differ between two sets of images
+//    ---------------------------------------------------------------
+static int DiffImages(const uint8_t *const from[CTRL_LANES], const uint8_t *const to[CTRL_LANES], int size)
+{
+    int pages = size / EEPROM_PAGE_SIZE;
+    int total = 0;
+
+    for (int l = 0; l < CTRL_LANES; l ++) {
+        int changed = 0;
+
+        for (int p = 0; p < pages; ) {
+            if (memcmp(from[l] + p * EEPROM_PAGE_SIZE, to[l] + p * EEPROM_PAGE_SIZE, EEPROM_PAGE_SIZE) == 0) {
+                p ++;
+                continue;
+            }
+
+            int first = p;
+
+            while (p < pages && memcmp(from[l] + p * EEPROM_PAGE_SIZE, to[l] + p * EEPROM_PAGE_SIZE,
+                    EEPROM_PAGE_SIZE) != 0) p ++;
+
+            printf("%s %04x-%04x\n", laneFile[l], first * EEPROM_PAGE_SIZE, p * EEPROM_PAGE_SIZE - 1);
+            changed += p - first;
+        }
+
+        total += changed;
+    }
+
+    printf("%d page(s) differ\n", total);
+
+    return total;
+}
+
+
+
+//
+// -- Tell the user how to run this
+//    -----------------------------
+static void Usage(const char *pgm)
+{
+    fprintf(stderr, "Usage: %s history [list] [--store <dir>]\n", pgm);
+    fprintf(stderr, "       %s history checkout <build> [--store <dir>] [--output <dir>]\n", pgm);
+    fprintf(stderr, "       %s history diff <build> [<build>] [--store <dir>] [--output <dir>]\n", pgm);
+    fprintf(stderr, "  <build>           a build id from `history list`, or enough of the start of one\n");
+    fprintf(stderr, "  --store <dir>     the store (default %s)\n", STORE_DIR);
+    fprintf(stderr, "  --output <dir>    write (checkout) or compare with (diff) the images in <dir>\n");
+}
+
+
+
+//
+// -- The `history` subcommand: list the builds in the store, bring one back, or compare two (or one with the
+//    images on disk)
+//    -------------------------------------------------------------------------------------------------------
+int History(const char *pgm, int argc, char *argv[])
+{
+    const char *store = STORE_DIR;
+    const char *dir = NULL;
+    const char *action = NULL;
+    const char *ids[2] = { NULL, NULL };
+    int count = 0;
+
+    for (int i = 0; i < argc; i ++) {
+        if (strcmp(argv[i], "--store") == 0 && i + 1 < argc) store = argv[++ i];
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) dir = argv[++ i];
+        else if (argv[i][0] != '-' && !action) action = argv[i];
+        else if (argv[i][0] != '-' && count < 2) ids[count ++] = argv[i];
+        else {
+            Usage(pgm);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!action || strcmp(action, "list") == 0) {
+        if (count) {
+            Usage(pgm);
+            return EXIT_FAILURE;
+        }
+
+        return ListBuilds(store) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    bool checkout = strcmp(action, "checkout") == 0;
+
+    if ((!checkout && strcmp(action, "diff") != 0) || count < 1 || (checkout && count != 1)) {
+        Usage(pgm);
+        return EXIT_FAILURE;
+    }
+
+
+    // -- bring back the build(s) named
+    Build build[2];
+    Store st;
+
+    if (!FindBuild(store, ids[0], &build[0])) return EXIT_FAILURE;
+    if (count > 1 && !FindBuild(store, ids[1], &build[1])) return EXIT_FAILURE;
+
+    int size = build[0].size;
+
+    if (count > 1 && build[1].size != size) {
+        fprintf(stderr, "%s: builds %s and %s are for different part sizes\n", pgm, build[0].id, build[1].id);
+        return EXIT_FAILURE;
+    }
+
+    uint8_t *image = (uint8_t *)malloc((size_t)size * CTRL_LANES * 2);
+    uint8_t *from[CTRL_LANES];
+    uint8_t *to[CTRL_LANES];
+
+    if (!image) {
+        fprintf(stderr, "Out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    for (int l = 0; l < CTRL_LANES; l ++) {
+        from[l] = image + (size_t)l * size;
+        to[l] = image + (size_t)(CTRL_LANES + l) * size;
+    }
+
+    bool ok = OpenStore(&st, store, false) && LoadBuild(&st, &build[0], from);
+
+    if (ok && checkout) {
+        ok = WriteImages(dir, from, size) && WritePolarity(dir, build[0].activeLow);
+        if (ok) printf("Build %s (%s, %s) written\n", build[0].id, build[0].when, build[0].source);
+    } else if (ok) {
+        if (count > 1) ok = LoadBuild(&st, &build[1], to);
+        else for (int l = 0; ok && l < CTRL_LANES; l ++) ok = ReadImage(dir, l, to[l], size);
+
+        if (ok) DiffImages(from, to, size);
+    }
+
+    CloseStore(&st);
+    free(image);
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,326 @@
+//===================================================================================================================
+//  upload.cc -- Upload the images to TommyPROM, one EEPROM after the other
+//
+//  This replaces typing `W0000` into minicom and starting an XMODEM send by hand 12 times.  For each image, in
+//  order, we ask for its EEPROM to be put into the programmer, then tell TommyPROM to write from each address
+//  (`Wssss`) and send the data with XMODEM-CRC, waiting for its `>` prompt in between.
+//
+//  With `--plan`, only the ranges in `ctrlN.plan` are sent (each rounded up to whole XMODEM blocks, using the
+//  image's own bytes so nothing else in the part changes), and an EEPROM with nothing to program is skipped
+//  without asking for it at all.
+//
+//  -----------------------------------------------------------------------------------------------------------------
+//
+//     Date      Tracker  Version  Pgmr  Description
+//  -----------  -------  -------  ----  ---------------------------------------------------------------------------
+//  2026-Oct-16  Initial  v0.0.1   ADCL  Initial version
+//  2026-Oct-16  Initial  v0.0.2   ADCL  Skip the EEPROMs whose images were pruned
+//
+//===================================================================================================================
+
+
+#include <cstdint>
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "eeprom.h"
+
+
+
+//
+// -- How long TommyPROM gets to come back with its prompt after a reset (opening the port resets the Arduino)
+//    --------------------------------------------------------------------------------------------------------
+const int RESET_MS = 3000;
+
+
+
+//
+// -- One range of addresses to send
+//    ------------------------------
+typedef struct Range {
+    int start;
+    int len;
+} Range;
+
+
+
+//
+// -- Tell the user how to run this
+//    -----------------------------
+static void Usage(const char *pgm)
+{
+    fprintf(stderr, "Usage: %s upload <tty> [--output <dir>] [--size <bytes>] [--plan] [--no-wait]\n", pgm);
+    fprintf(stderr, "  --output <dir>    upload the images from <dir> rather than the current directory\n");
+    fprintf(stderr, "  --size <bytes>    the size of the images (default %d)\n", PROM_SIZE);
+    fprintf(stderr, "  --plan            only upload the ranges in each ctrlN.plan\n");
+    fprintf(stderr, "  --no-wait         do not wait for each EEPROM to be put in the programmer\n");
+}
+
+
+
+//
+// -- Wait for TommyPROM's prompt, throwing away whatever it says on the way
+//    ----------------------------------------------------------------------
+bool WaitPrompt(int fd, int ms)
+{
+    int c;
+
+    do c = ReadByte(fd, ms); while (c >= 0 && c != '>');
+
+    return c == '>';
+}
+
+
+
+//
+// -- Wait for TommyPROM to be ready after the port is opened; opening the port resets the Arduino, and if it has
+//    nothing to say after that, poke it
+//    -----------------------------------------------------------------------------------------------------------
+bool WaitReady(int fd, const char *tty)
+{
+    if (WaitPrompt(fd, RESET_MS) || (PromptCommand(fd, "") && WaitPrompt(fd, PROMPT_MS))) return true;
+
+    fprintf(stderr, "No prompt from the programmer on %s\n", tty);
+    return false;
+}
+
+
+
+//
+// -- Send a command, ended the way TommyPROM expects
+//    -----------------------------------------------
+bool PromptCommand(int fd, const char *cmd)
+{
+    return SendBytes(fd, cmd, strlen(cmd)) && SendBytes(fd, "\r", 1);
+}
+
+
+
+//
+// -- Read the ranges to send from the plan for a lane; the whole image if there is no plan.  A plan with more
+//    than `capacity` ranges, or with ranges out of order or overlapping, has been damaged: -1 (and reported).
+//    --------------------------------------------------------------------------------------------------------
+static int ReadRanges(const char *dir, int lane, int size, bool usePlan, Range *ranges, int capacity)
+{
+    char path[FILENAME_MAX];
+    char line[64];
+    unsigned first, last;
+    int lineNo = 0;
+    int next = 0;                            // where the next range may start
+    int count = 0;
+
+    ranges[0].start = 0;
+    ranges[0].len = size;
+
+    if (!usePlan) return 1;
+
+    LaneSidePath(path, sizeof(path), dir, lane, ".plan");
+
+    FILE *fp = fopen(path, "r");
+
+    if (!fp) {
+        printf("%s: no plan; uploading the whole image\n", laneFile[lane]);
+        return 1;
+    }
+
+    while (fgets(line, sizeof(line), fp)) {
+        lineNo ++;
+
+        if (sscanf(line, "%x-%x", &first, &last) != 2 || first > last || (int)last >= size) continue;
+
+        if ((int)first < next) {
+            fprintf(stderr, "%s:%d: this range is out of order or overlaps the one before\n", path, lineNo);
+            fclose(fp);
+            return -1;
+        }
+
+        if (count == capacity) {
+            fprintf(stderr, "%s:%d: more than %d ranges\n", path, lineNo, capacity);
+            fclose(fp);
+            return -1;
+        }
+
+        next = last + 1;
+
+        // -- whole XMODEM blocks, filled out with the image itself
+        int len = (last - first + XMODEM_BLOCK) / XMODEM_BLOCK * XMODEM_BLOCK;
+        if ((int)first + len > size) len = size - first;
+
+        ranges[count].start = first;
+        ranges[count].len = len;
+        count ++;
+    }
+
+    fclose(fp);
+
+    return count;
+}
+
+
+
+//
+// -- Ask for the next EEPROM; false to skip it.  `q` (or the end of the input) stops everything.
+//    -------------------------------------------------------------------------------------------
+bool AskForChip(int lane, bool *quit)
+{
+    char line[64];
+
+    printf("Put the EEPROM for %s in the programmer and press Enter (`s` to skip it, `q` to stop): ",
+            laneFile[lane]);
+    fflush(stdout);
+
+    if (!fgets(line, sizeof(line), stdin) || line[0] == 'q') {
+        *quit = true;
+        return false;
+    }
+
+    return line[0] != 's';
+}
+
+
+
+//
+// -- Upload one image
+//    ----------------
+static bool UploadLane(int fd, const uint8_t *image, const Range *ranges, int count)
+{
+    char cmd[32];
+
+    for (int r = 0; r < count; r ++) {
+        snprintf(cmd, sizeof(cmd), "W%04x", ranges[r].start);
+
+        if (!PromptCommand(fd, cmd)) {
+            fprintf(stderr, "Unable to send to the programmer: %s\n", strerror(errno));
+            return false;
+        }
+
+        if (!XmodemSend(fd, image + ranges[r].start, ranges[r].len)) return false;
+
+        if (!WaitPrompt(fd, PROMPT_MS)) {
+            fprintf(stderr, "The programmer did not come back after writing at 0x%04x\n", ranges[r].start);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+
+//
+// -- The `upload` subcommand
+//    -----------------------
+int Upload(const char *pgm, int argc, char *argv[])
+{
+    static Range ranges[MAX_PROM_SIZE / EEPROM_PAGE_SIZE];
+    char path[FILENAME_MAX];
+    const char *tty = NULL;
+    const char *dir = NULL;
+    int size = PROM_SIZE;
+    bool usePlan = false;
+    bool wait = true;
+    bool quit = false;
+
+    for (int i = 0; i < argc; i ++) {
+        if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) dir = argv[++ i];
+        else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) size = strtol(argv[++ i], NULL, 0);
+        else if (strcmp(argv[i], "--plan") == 0) usePlan = true;
+        else if (strcmp(argv[i], "--no-wait") == 0) wait = false;
+        else if (argv[i][0] != '-' && !tty) tty = argv[i];
+        else {
+            Usage(pgm);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!tty || size < PROM_SIZE || size > MAX_PROM_SIZE || (size & (size - 1)) != 0) {
+        Usage(pgm);
+        return EXIT_FAILURE;
+    }
+
+    int fd = OpenSerial(tty);
+    if (fd < 0) return EXIT_FAILURE;
+
+    if (!WaitReady(fd, tty)) {
+        close(fd);
+        return EXIT_FAILURE;
+    }
+
+    for (int l = 0; l < CTRL_LANES && !quit; l ++) {
+        struct stat st;
+        struct timespec start, end;
+
+        LanePath(path, sizeof(path), dir, l);
+
+        if (access(path, F_OK) != 0 && errno == ENOENT) {
+            printf("%s: no image (pruned); skipped\n", laneFile[l]);
+            continue;
+        }
+
+        int count = ReadRanges(dir, l, size, usePlan, ranges, sizeof(ranges) / sizeof(ranges[0]));
+
+        if (count < 0) {
+            close(fd);
+            return EXIT_FAILURE;
+        }
+
+        if (count == 0) {
+            printf("%s: nothing to program\n", laneFile[l]);
+            continue;
+        }
+
+        int img = open(path, O_RDONLY);
+
+        if (img < 0 || fstat(img, &st) != 0 || st.st_size != size) {
+            fprintf(stderr, "Unable to read %s: %s\n", path, img < 0 ? strerror(errno) : "not the size of the part");
+            if (img >= 0) close(img);
+            close(fd);
+            return EXIT_FAILURE;
+        }
+
+        void *image = mmap(NULL, size, PROT_READ, MAP_SHARED, img, 0);
+        close(img);
+
+        if (image == MAP_FAILED) {
+            fprintf(stderr, "Unable to map %s: %s\n", path, strerror(errno));
+            close(fd);
+            return EXIT_FAILURE;
+        }
+
+        if (wait && !AskForChip(l, &quit)) {
+            munmap(image, size);
+            if (!quit) printf("%s: skipped\n", laneFile[l]);
+            continue;
+        }
+
+        int bytes = 0;
+        for (int r = 0; r < count; r ++) bytes += ranges[r].len;
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        bool ok = UploadLane(fd, (const uint8_t *)image, ranges, count);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        munmap(image, size);
+
+        if (!ok) {
+            fprintf(stderr, "%s: upload failed\n", laneFile[l]);
+            close(fd);
+            return EXIT_FAILURE;
+        }
+
+        printf("%s: %d byte(s) in %d range(s) uploaded in %.1f s\n", laneFile[l], bytes, count,
+                (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9);
+        fflush(stdout);
+    }
+
+    close(fd);
+
+    return quit ? EXIT_FAILURE : EXIT_SUCCESS;
+}
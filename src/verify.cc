@@ -0,0 +1,355 @@
+//===================================================================================================================
+//  verify.cc -- Check what was read back from the EEPROMs against the images
+//
+//  The read-back is streamed, either from TommyPROM (`Rssss eeee`, sent with XMODEM-CRC) or from a dump file, and
+//  is never held in full: it is gathered one 64-byte page at a time and the CRC-32 of each page is checked against
+//  the CRC-32 of the same page of the image.  Only when a page does not match are its bytes compared, to report
+//  the addresses which differ.  The first few of those are reported along with a count of the bad pages.
+//
+//  Given a programmer, every EEPROM is asked for and checked in turn.  Given a dump file, `--lane` says which
+//  image it is checked against.
+//
+//  -----------------------------------------------------------------------------------------------------------------
+//
+//     Date      Tracker  Version  Pgmr  Description
+//  -----------  -------  -------  ----  ---------------------------------------------------------------------------
+//  2026-Oct-16  Initial  v0.0.1   ADCL  Initial version
+//  2026-Oct-16  Initial  v0.0.2   ADCL  Skip the EEPROMs whose images were pruned
+//
+//===================================================================================================================
+
+
+#include <cstdint>
+#include <stdio.h>
+#include <stdlib.h>
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "eeprom.h"
+
+
+
+//
+// -- How many differing addresses to report for each EEPROM
+//    ------------------------------------------------------
+const int MAX_REPORTED = 8;
+
+
+
+//
+// -- One lane being checked: the image (mapped), the CRC of each of its pages and the page being gathered
+//    ----------------------------------------------------------------------------------------------------
+typedef struct Checker {
+    int lane;
+    const uint8_t *image;
+    int size;
+    uint32_t crc[MAX_PROM_SIZE / EEPROM_PAGE_SIZE];
+    uint8_t page[EEPROM_PAGE_SIZE];
+    int fill;                                // bytes gathered in `page`
+    long addr;                               // the address of the next byte to arrive
+    int badPages;
+    int reported;
+} Checker;
+
+
+
+//
+// -- Check one whole page
+//    --------------------
+static void CheckPage(Checker *chk)
+{
+    long base = chk->addr - EEPROM_PAGE_SIZE;
+
+    if (Crc32(0, chk->page, EEPROM_PAGE_SIZE) == chk->crc[base / EEPROM_PAGE_SIZE]) return;
+
+    chk->badPages ++;
+
+    for (int i = 0; i < EEPROM_PAGE_SIZE && chk->reported < MAX_REPORTED; i ++) {
+        if (chk->page[i] == chk->image[base + i]) continue;
+
+        printf("%s: 0x%04lx: expected 0x%02x, read 0x%02x\n", laneFile[chk->lane], base + i, chk->image[base + i],
+                chk->page[i]);
+        chk->reported ++;
+    }
+}
+
+
+
+//
+// -- Take the next bytes of the read-back; anything past the end of the part is ignored
+//    ----------------------------------------------------------------------------------
+static bool Feed(void *ctx, const uint8_t *data, int len)
+{
+    Checker *chk = (Checker *)ctx;
+
+    while (len > 0 && chk->addr < chk->size) {
+        int n = EEPROM_PAGE_SIZE - chk->fill;
+        if (n > len) n = len;
+
+        memcpy(&chk->page[chk->fill], data, n);
+        chk->fill += n;
+        chk->addr += n;
+        data += n;
+        len -= n;
+
+        if (chk->fill == EEPROM_PAGE_SIZE) {
+            CheckPage(chk);
+            chk->fill = 0;
+        }
+    }
+
+    return true;
+}
+
+
+
+//
+// -- Map the image for a lane and work out the CRC of each page
+//    ----------------------------------------------------------
+static bool StartLane(Checker *chk, const char *dir, int lane, int size)
+{
+    char path[FILENAME_MAX];
+    struct stat st;
+
+    LanePath(path, sizeof(path), dir, lane);
+
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size != size) {
+        fprintf(stderr, "Unable to read %s: %s\n", path, fd < 0 ? strerror(errno) : "not the size of the part");
+        if (fd >= 0) close(fd);
+        return false;
+    }
+
+    void *addr = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (addr == MAP_FAILED) {
+        fprintf(stderr, "Unable to map %s: %s\n", path, strerror(errno));
+        return false;
+    }
+
+    chk->lane = lane;
+    chk->image = (const uint8_t *)addr;
+    chk->size = size;
+    chk->fill = 0;
+    chk->addr = 0;
+    chk->badPages = 0;
+    chk->reported = 0;
+
+    for (int p = 0; p < size / EEPROM_PAGE_SIZE; p ++) {
+        chk->crc[p] = Crc32(0, chk->image + p * EEPROM_PAGE_SIZE, EEPROM_PAGE_SIZE);
+    }
+
+    return true;
+}
+
+
+
+//
+// -- Report on a lane once the read-back is over; true if it matched
+//    ---------------------------------------------------------------
+static bool FinishLane(Checker *chk)
+{
+    bool ok = chk->addr == chk->size && chk->badPages == 0;
+
+    munmap((void *)chk->image, chk->size);
+
+    if (chk->addr < chk->size) {
+        printf("%s: the read-back stopped at 0x%04lx, short of the %d byte(s) expected\n", laneFile[chk->lane],
+                chk->addr, chk->size);
+    } else if (chk->badPages) {
+        printf("%s: %d of %d page(s) differ\n", laneFile[chk->lane], chk->badPages, chk->size / EEPROM_PAGE_SIZE);
+    } else {
+        printf("%s: all %d page(s) match\n", laneFile[chk->lane], chk->size / EEPROM_PAGE_SIZE);
+    }
+
+    fflush(stdout);
+
+    return ok;
+}
+
+
+
+//
+// -- Check a dump file against one lane, a buffer at a time
+//    ------------------------------------------------------
+static bool VerifyFile(Checker *chk, int fd, const char *dump)
+{
+    static uint8_t buf[64 * 1024];
+
+    while (true) {
+        ssize_t got = read(fd, buf, sizeof(buf));
+
+        if (got < 0 && errno == EINTR) continue;
+
+        if (got < 0) {
+            fprintf(stderr, "Unable to read %s: %s\n", dump, strerror(errno));
+            return false;
+        }
+
+        if (got == 0) return true;
+
+        Feed(chk, buf, got);
+    }
+}
+
+
+
+//
+// -- Read back and check one EEPROM in the programmer
+//    ------------------------------------------------
+static bool VerifyChip(Checker *chk, int fd)
+{
+    char cmd[32];
+
+    snprintf(cmd, sizeof(cmd), "R%04x %04x", 0, chk->size - 1);
+
+    if (!PromptCommand(fd, cmd)) {
+        fprintf(stderr, "Unable to send to the programmer: %s\n", strerror(errno));
+        return false;
+    }
+
+    if (XmodemReceive(fd, Feed, chk) < 0) {
+        fprintf(stderr, "%s: the read-back failed\n", laneFile[chk->lane]);
+        return false;
+    }
+
+    if (!WaitPrompt(fd, PROMPT_MS)) {
+        fprintf(stderr, "The programmer did not come back after the read-back\n");
+        return false;
+    }
+
+    return true;
+}
+
+
+
+//
+// -- Tell the user how to run this
+//    -----------------------------
+static void Usage(const char *pgm)
+{
+    fprintf(stderr, "Usage: %s verify <tty> [--output <dir>] [--size <bytes>] [--no-wait]\n", pgm);
+    fprintf(stderr, "       %s verify <dump> --lane <n> [--output <dir>] [--size <bytes>]\n", pgm);
+    fprintf(stderr, "  --lane <n>        check the dump against ctrl<n>.bin (1..9, a..c)\n");
+    fprintf(stderr, "  --output <dir>    check against the images in <dir> rather than the current directory\n");
+    fprintf(stderr, "  --size <bytes>    the size of the images (default %d)\n", PROM_SIZE);
+    fprintf(stderr, "  --no-wait         do not wait for each EEPROM to be put in the programmer\n");
+}
+
+
+
+//
+// -- The `verify` subcommand
+//    -----------------------
+int Verify(const char *pgm, int argc, char *argv[])
+{
+    static Checker chk;
+    const char *source = NULL;
+    const char *dir = NULL;
+    int size = PROM_SIZE;
+    int lane = -1;
+    bool wait = true;
+    bool quit = false;
+
+    for (int i = 0; i < argc; i ++) {
+        if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) dir = argv[++ i];
+        else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) size = strtol(argv[++ i], NULL, 0);
+        else if (strcmp(argv[i], "--lane") == 0 && i + 1 < argc) lane = strtol(argv[++ i], NULL, 16) - 1;
+        else if (strcmp(argv[i], "--no-wait") == 0) wait = false;
+        else if (argv[i][0] != '-' && !source) source = argv[i];
+        else {
+            Usage(pgm);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!source || size < PROM_SIZE || size > MAX_PROM_SIZE || (size & (size - 1)) != 0) {
+        Usage(pgm);
+        return EXIT_FAILURE;
+    }
+
+    int fd = open(source, O_RDONLY | O_NOCTTY);
+
+    if (fd < 0) {
+        fprintf(stderr, "Unable to open %s: %s\n", source, strerror(errno));
+        return EXIT_FAILURE;
+    }
+
+
+    // -- a dump file is checked against one lane
+    if (!isatty(fd)) {
+        if (lane < 0 || lane >= CTRL_LANES) {
+            fprintf(stderr, "%s: which image is %s a dump of?  Give it with --lane\n", pgm, source);
+            close(fd);
+            return EXIT_FAILURE;
+        }
+
+        if (!StartLane(&chk, dir, lane, size)) {
+            close(fd);
+            return EXIT_FAILURE;
+        }
+
+        bool ok = VerifyFile(&chk, fd, source);
+
+        close(fd);
+        ok = FinishLane(&chk) && ok;
+
+        return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+
+    // -- otherwise, read back every EEPROM through the programmer
+    close(fd);
+
+    fd = OpenSerial(source);
+    if (fd < 0) return EXIT_FAILURE;
+
+    if (!WaitReady(fd, source)) {
+        close(fd);
+        return EXIT_FAILURE;
+    }
+
+    int bad = 0;
+
+    for (int l = 0; l < CTRL_LANES && !quit; l ++) {
+        char path[FILENAME_MAX];
+
+        LanePath(path, sizeof(path), dir, l);
+
+        if (access(path, F_OK) != 0 && errno == ENOENT) {
+            printf("%s: no image (pruned); skipped\n", laneFile[l]);
+            continue;
+        }
+
+        if (wait && !AskForChip(l, &quit)) {
+            if (!quit) printf("%s: skipped\n", laneFile[l]);
+            continue;
+        }
+
+        if (!StartLane(&chk, dir, l, size)) {
+            close(fd);
+            return EXIT_FAILURE;
+        }
+
+        bool ok = VerifyChip(&chk, fd);
+
+        if (!FinishLane(&chk)) bad ++;
+
+        if (!ok) {
+            close(fd);
+            return EXIT_FAILURE;
+        }
+    }
+
+    close(fd);
+
+    if (bad) printf("%d EEPROM(s) do not match their images\n", bad);
+
+    return bad || quit ? EXIT_FAILURE : EXIT_SUCCESS;
+}